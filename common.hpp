@@ -2,21 +2,41 @@
 #ifndef ADVENT_OF_CODE_2020_COMMON_HPP
 #define ADVENT_OF_CODE_2020_COMMON_HPP
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <span>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "extern/flow.hpp"
 
 #define FMT_HEADER_ONLY
@@ -73,6 +93,116 @@ lines(std::basic_istream<CharT, Traits>& is, CharT delim = CharT{'\n'})
     return detail::lines_flow<CharT, Traits>(is, delim);
 }
 
+// Reads a file in fixed-size chunks, double-buffered: while the caller works
+// on the current chunk, the next one is being read on a background thread,
+// so that for cold-cache inputs the I/O latency hides behind the parsing.
+class prefetch_reader {
+    std::ifstream file_;
+    std::size_t chunk_size_;
+    std::string current_;
+    std::future<std::string> next_;
+
+    // The buffer handed out last time is recycled for the next read
+    auto fetch(std::string buf) -> std::future<std::string>
+    {
+        return std::async(std::launch::async, [this, buf = std::move(buf)] () mutable {
+            buf.resize(chunk_size_);
+            file_.read(buf.data(), buf.size());
+            buf.resize(file_.gcount());
+            return std::move(buf);
+        });
+    }
+
+public:
+    explicit prefetch_reader(const char* path, std::size_t chunk_size = 1 << 20)
+        : file_(path, std::ios::binary),
+          chunk_size_(chunk_size)
+    {
+        next_ = fetch({});
+    }
+
+    // The background read refers to this object
+    prefetch_reader(const prefetch_reader&) = delete;
+    prefetch_reader& operator=(const prefetch_reader&) = delete;
+
+    // Returns an empty view at the end of the file. The view is valid until
+    // the next call.
+    auto next_chunk() -> std::string_view
+    {
+        if (!next_.valid()) {
+            return {};
+        }
+
+        auto buf = next_.get();
+        if (buf.empty()) {
+            return {};
+        }
+
+        std::swap(current_, buf);
+        next_ = fetch(std::move(buf));
+        return current_;
+    }
+};
+
+namespace detail {
+
+struct prefetch_lines_flow : flow::flow_base<prefetch_lines_flow> {
+private:
+    std::unique_ptr<prefetch_reader> reader_;
+    std::string_view chunk_;
+    // Holds a line which straddles a chunk boundary
+    std::string carry_;
+    bool carry_returned_ = false;
+    char delim_;
+
+public:
+    prefetch_lines_flow(const char* path, char delim, std::size_t chunk_size)
+        : reader_(std::make_unique<prefetch_reader>(path, chunk_size)),
+          delim_(delim)
+    {}
+
+    auto next() -> flow::maybe<std::string_view>
+    {
+        if (carry_returned_) {
+            carry_.clear();
+            carry_returned_ = false;
+        }
+
+        while (true) {
+            if (auto idx = chunk_.find(delim_); idx != chunk_.npos) {
+                auto line = chunk_.substr(0, idx);
+                chunk_.remove_prefix(idx + 1);
+                if (carry_.empty()) {
+                    return line;
+                }
+                carry_.append(line);
+                carry_returned_ = true;
+                return std::string_view(carry_);
+            }
+
+            carry_.append(chunk_);
+            chunk_ = reader_->next_chunk();
+
+            if (chunk_.empty()) {
+                if (carry_.empty()) {
+                    return {};
+                }
+                carry_returned_ = true;
+                return std::string_view(carry_);
+            }
+        }
+    }
+};
+
+}
+
+// Like lines(), but reading through a prefetch_reader. Chunk boundaries are
+// invisible to the caller; each line is valid until the next one is read.
+auto prefetch_lines(const char* path, char delim = '\n', std::size_t chunk_size = 1 << 20)
+{
+    return detail::prefetch_lines_flow(path, delim, chunk_size);
+}
+
 // This function is not great, but nor are the alternatives:
 //  * std::from_chars - not constexpr, requires contiguous input
 //  * std::atoi - same
@@ -139,6 +269,135 @@ private:
 
 namespace detail {
 
+struct trace_event {
+    std::string name;
+    std::size_t tid;
+    std::int64_t begin_us;
+    std::int64_t end_us;
+};
+
+// Collects the events recorded by trace_scope. If the AOC_TRACE environment
+// variable names a file, everything recorded is written there on exit as
+// Chrome trace-event JSON (load it in chrome://tracing or ui.perfetto.dev)
+class trace_log {
+    using clock = std::chrono::steady_clock;
+
+    std::string path_;
+    clock::time_point start_ = clock::now();
+    std::mutex mtx_;
+    std::vector<trace_event> events_;
+
+    trace_log()
+    {
+        if (const char* path = std::getenv("AOC_TRACE")) {
+            path_ = path;
+        }
+    }
+
+    static void write_escaped(std::FILE* file, std::string_view str)
+    {
+        for (char c : str) {
+            switch (c) {
+            case '"': fmt::print(file, "\\\""); break;
+            case '\\': fmt::print(file, "\\\\"); break;
+            case '\n': fmt::print(file, "\\n"); break;
+            default: std::fputc(c, file);
+            }
+        }
+    }
+
+public:
+    trace_log(const trace_log&) = delete;
+    trace_log& operator=(const trace_log&) = delete;
+
+    ~trace_log()
+    {
+        if (!enabled()) {
+            return;
+        }
+
+        std::FILE* file = std::fopen(path_.c_str(), "w");
+        if (!file) {
+            fmt::print(stderr, "Could not open trace file '{}'\n", path_);
+            return;
+        }
+
+        fmt::print(file, "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+        for (std::size_t i = 0; i < events_.size(); i++) {
+            auto const& ev = events_[i];
+            fmt::print(file, "{}\n{{\"name\":\"", i == 0 ? "" : ",");
+            write_escaped(file, ev.name);
+            fmt::print(file, "\",\"cat\":\"aoc\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{},\"dur\":{}}}",
+                       ev.tid, ev.begin_us, ev.end_us - ev.begin_us);
+        }
+        fmt::print(file, "\n]}}\n");
+        std::fclose(file);
+    }
+
+    static auto instance() -> trace_log&
+    {
+        static trace_log log;
+        return log;
+    }
+
+    auto enabled() const -> bool { return !path_.empty(); }
+
+    auto now() const -> std::int64_t
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start_).count();
+    }
+
+    // Small, stable per-thread ids read better in the trace viewer than
+    // hashed std::thread::ids
+    static auto thread_index() -> std::size_t
+    {
+        static std::atomic<std::size_t> next_index{1};
+        thread_local const std::size_t index = next_index++;
+        return index;
+    }
+
+    void record(trace_event event)
+    {
+        std::lock_guard lock(mtx_);
+        events_.push_back(std::move(event));
+    }
+};
+
+}
+
+// RAII marker for a named region of code. Scopes nest naturally: the trace
+// viewer stacks each thread's events by their begin/end times. Costs a single
+// branch when tracing is disabled.
+class trace_scope {
+    std::string name_;
+    std::int64_t begin_ = -1;
+
+public:
+    explicit trace_scope(std::string_view name)
+    {
+        auto& log = detail::trace_log::instance();
+        if (log.enabled()) {
+            name_ = name;
+            begin_ = log.now();
+        }
+    }
+
+    trace_scope(const trace_scope&) = delete;
+    trace_scope& operator=(const trace_scope&) = delete;
+
+    ~trace_scope()
+    {
+        if (begin_ < 0) {
+            return;
+        }
+
+        auto& log = detail::trace_log::instance();
+        log.record({std::move(name_), detail::trace_log::thread_index(), begin_, log.now()});
+    }
+};
+
+namespace detail {
+
 struct split_string_flow : flow::flow_base<split_string_flow>
 {
     constexpr split_string_flow(std::string_view str, std::string_view pattern)
@@ -173,6 +432,483 @@ constexpr auto split_string = [](std::string_view str,
     return detail::split_string_flow(str, pattern);
 };
 
+// flow's to_vector() can't be used in constant expressions, but these can
+constexpr auto split_to_vector = [](std::string_view str, std::string_view pattern)
+    -> std::vector<std::string_view>
+{
+    std::vector<std::string_view> vec;
+    split_string(str, pattern).for_each([&vec](std::string_view sv) { vec.push_back(sv); });
+    return vec;
+};
+
+constexpr auto parse_ints = [](std::string_view str, std::string_view pattern)
+    -> std::vector<int>
+{
+    std::vector<int> vec;
+    split_string(str, pattern).for_each([&vec](std::string_view sv) {
+        vec.push_back(try_parse<int>(sv).value());
+    });
+    return vec;
+};
+
+// Read-only memory mapping of a whole file. Evaluates to false if the file
+// could not be opened or mapped.
+class mapped_file {
+    void* addr_ = nullptr;
+    std::size_t size_ = 0;
+
+public:
+    explicit mapped_file(const char* path)
+    {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+
+        struct stat st{};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                addr_ = addr;
+                size_ = st.st_size;
+            }
+        }
+
+        ::close(fd);
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file()
+    {
+        if (addr_) {
+            ::munmap(addr_, size_);
+        }
+    }
+
+    explicit operator bool() const { return addr_ != nullptr; }
+
+    auto bytes() const -> std::span<const char>
+    {
+        return {static_cast<const char*>(addr_), size_};
+    }
+};
+
+constexpr auto fnv1a_64 = [](std::string_view str) -> std::uint64_t
+{
+    std::uint64_t hash = 0xcbf29ce484222325;
+    for (char c : str) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+};
+
+namespace detail {
+
+// The cache format is deliberately dumb: a magic number and a signature of
+// the cached type, followed by each vector as (element count, element size,
+// raw bytes). Anything that's a vector of trivially-copyable elements, or a
+// pair/tuple of such vectors, can be cached.
+constexpr std::string_view cache_magic = "AOCCACHE";
+
+// The (compiler-specific) name of T, including any template arguments
+template <typename T>
+constexpr auto type_name() -> std::string_view
+{
+    return __PRETTY_FUNCTION__;
+}
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+void write_cached(std::string& out, const std::vector<T>& vec)
+{
+    const std::uint64_t header[] = {vec.size(), sizeof(T)};
+    out.append(reinterpret_cast<const char*>(header), sizeof(header));
+    out.append(reinterpret_cast<const char*>(vec.data()), vec.size() * sizeof(T));
+}
+
+template <typename... Ts>
+void write_cached(std::string& out, const std::tuple<Ts...>& tup)
+{
+    std::apply([&out](const auto&... elems) { (write_cached(out, elems), ...); }, tup);
+}
+
+template <typename T, typename U>
+void write_cached(std::string& out, const std::pair<T, U>& pair)
+{
+    write_cached(out, pair.first);
+    write_cached(out, pair.second);
+}
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+auto read_cached(std::span<const char>& in, std::vector<T>& vec) -> bool
+{
+    std::uint64_t header[2];
+    if (in.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(header, in.data(), sizeof(header));
+    in = in.subspan(sizeof(header));
+
+    if (header[1] != sizeof(T) || in.size() / sizeof(T) < header[0]) {
+        return false;
+    }
+
+    vec.resize(header[0]);
+    std::memcpy(vec.data(), in.data(), vec.size() * sizeof(T));
+    in = in.subspan(vec.size() * sizeof(T));
+    return true;
+}
+
+template <typename... Ts>
+auto read_cached(std::span<const char>& in, std::tuple<Ts...>& tup) -> bool
+{
+    return std::apply([&in](auto&... elems) { return (read_cached(in, elems) && ...); }, tup);
+}
+
+template <typename T, typename U>
+auto read_cached(std::span<const char>& in, std::pair<T, U>& pair) -> bool
+{
+    return read_cached(in, pair.first) && read_cached(in, pair.second);
+}
+
+}
+
+// Runs parse(input), unless the AOC_CACHE_DIR environment variable is set
+// and an earlier run has already left the parsed result there. Cache files
+// are keyed on the tag, format version and a hash of the input text, and are
+// memory-mapped straight back into the result without going near the parser.
+//
+// Nothing can tell that a cached struct's fields have been reordered, so bump
+// the version whenever the layout of the parsed types changes. Files written
+// with another version, or for a differently-named type, are ignored.
+template <typename Parser>
+auto cached_parse(std::string_view tag, int version, std::string_view input, Parser parse)
+    -> std::invoke_result_t<Parser&, std::string_view>
+{
+    using result_t = std::invoke_result_t<Parser&, std::string_view>;
+
+    const char* dir = std::getenv("AOC_CACHE_DIR");
+    if (!dir) {
+        return parse(input);
+    }
+
+    const auto path = fmt::format("{}/{}-v{}-{:016x}.bin", dir, tag, version, fnv1a_64(input));
+    const std::uint64_t signature =
+        fnv1a_64(fmt::format("{}/v{}/{}", tag, version, detail::type_name<result_t>()));
+
+    if (auto file = mapped_file(path.c_str())) {
+        auto bytes = file.bytes();
+        result_t result{};
+        const auto header_size = detail::cache_magic.size() + sizeof(signature);
+        if (bytes.size() >= header_size &&
+            std::string_view(bytes.data(), detail::cache_magic.size()) == detail::cache_magic &&
+            std::memcmp(bytes.data() + detail::cache_magic.size(), &signature, sizeof(signature)) == 0) {
+            bytes = bytes.subspan(header_size);
+            if (detail::read_cached(bytes, result) && bytes.empty()) {
+                return result;
+            }
+        }
+        fmt::print(stderr, "Ignoring invalid cache file '{}'\n", path);
+    }
+
+    result_t result = parse(input);
+
+    std::string out(detail::cache_magic);
+    out.append(reinterpret_cast<const char*>(&signature), sizeof(signature));
+    detail::write_cached(out, result);
+    // Write to a temporary and rename, so that a concurrent reader never
+    // sees a partial file
+    const auto tmp_path = fmt::format("{}.{}-{}.tmp", path, ::getpid(),
+                                      std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    if (std::ofstream file(tmp_path, std::ios::binary); file.write(out.data(), out.size())) {
+        file.close();
+        std::rename(tmp_path.c_str(), path.c_str());
+    } else {
+        fmt::print(stderr, "Could not write cache file '{}'\n", path);
+    }
+
+    return result;
+}
+
+// A fixed set of worker threads servicing a shared FIFO queue of tasks
+class thread_pool {
+    std::vector<std::thread> threads_;
+    std::deque<std::function<void()>> queue_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+
+    inline static thread_local bool in_worker_ = false;
+
+    void run()
+    {
+        in_worker_ = true;
+
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mtx_);
+                cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+                task = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            task();
+        }
+    }
+
+public:
+    explicit thread_pool(std::size_t n_threads)
+    {
+        n_threads = std::max<std::size_t>(n_threads, 1);
+        for (std::size_t i = 0; i < n_threads; i++) {
+            threads_.emplace_back([this] { run(); });
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Finishes everything already queued before joining
+    ~thread_pool()
+    {
+        {
+            std::lock_guard lock(mtx_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    template <typename F>
+    auto submit(F func) -> std::future<std::invoke_result_t<F&>>
+    {
+        using result_t = std::invoke_result_t<F&>;
+
+        // std::function needs a copyable callable, packaged_task isn't one
+        auto task = std::make_shared<std::packaged_task<result_t()>>(std::move(func));
+        auto future = task->get_future();
+        {
+            std::lock_guard lock(mtx_);
+            queue_.emplace_back([task] { (*task)(); });
+        }
+        cv_.notify_one();
+        return future;
+    }
+
+    auto size() const -> std::size_t { return threads_.size(); }
+
+    // Waiting on pool tasks from inside a pool task can deadlock once every
+    // worker is doing it, so parallel algorithms should check this and just
+    // run inline instead
+    static auto on_worker_thread() -> bool { return in_worker_; }
+};
+
+// Shared pool used by batch mode and the parallel solvers. Sized by the
+// AOC_THREADS environment variable, or the hardware concurrency by default.
+auto default_pool() -> thread_pool&
+{
+    static thread_pool pool([] () -> std::size_t {
+        if (const char* env = std::getenv("AOC_THREADS")) {
+            if (auto n = try_parse<int>(std::string_view(env)); n && *n > 0) {
+                return *n;
+            }
+        }
+        return std::thread::hardware_concurrency();
+    }());
+    return pool;
+}
+
+namespace detail {
+
+// Waits for all the futures when destroyed. Pool tasks refer to their
+// caller's stack, so if the caller throws, it must not unwind until every
+// task it has submitted has finished.
+template <typename Future>
+class wait_all {
+    std::vector<Future>& futures_;
+
+public:
+    explicit wait_all(std::vector<Future>& futures) : futures_(futures) {}
+
+    wait_all(const wait_all&) = delete;
+    wait_all& operator=(const wait_all&) = delete;
+
+    ~wait_all()
+    {
+        for (auto& f : futures_) {
+            if (f.valid()) {
+                f.wait();
+            }
+        }
+    }
+};
+
+}
+
+// Splits [0, n) into chunks of at least min_chunk elements, evaluates
+// func(first, last) for each chunk on the default pool (and the calling
+// thread), and folds the results into init with op, in chunk order. Runs
+// inline if there's only one chunk or we're already on a pool thread.
+template <typename T, typename Func, typename Op = std::plus<>>
+auto parallel_reduce(std::size_t n, std::size_t min_chunk, T init, Func func, Op op = {}) -> T
+{
+    auto& pool = default_pool();
+    const std::size_t n_chunks = thread_pool::on_worker_thread() ? 1 :
+        std::clamp<std::size_t>(n / std::max<std::size_t>(min_chunk, 1), 1, pool.size() + 1);
+
+    if (n_chunks == 1) {
+        return op(std::move(init), func(std::size_t{0}, n));
+    }
+
+    auto chunk_bounds = [&](std::size_t i) {
+        return std::pair(n * i / n_chunks, n * (i + 1) / n_chunks);
+    };
+
+    std::vector<std::future<std::invoke_result_t<Func&, std::size_t, std::size_t>>> futures;
+    const detail::wait_all guard(futures);
+    for (std::size_t i = 0; i + 1 < n_chunks; i++) {
+        futures.push_back(pool.submit([&func, bounds = chunk_bounds(i)] {
+            return func(bounds.first, bounds.second);
+        }));
+    }
+
+    auto [first, last] = chunk_bounds(n_chunks - 1);
+    auto last_result = func(first, last);
+
+    for (auto& f : futures) {
+        init = op(std::move(init), f.get());
+    }
+    return op(std::move(init), std::move(last_result));
+}
+
+// Runs func(i) for each i in [0, n) on the default pool (and the calling
+// thread), returning once all are done. Meant for coarse-grained tasks; runs
+// inline if we're already on a pool thread.
+template <typename Func>
+void parallel_for(std::size_t n, Func func)
+{
+    if (n == 0) {
+        return;
+    }
+
+    if (n == 1 || thread_pool::on_worker_thread()) {
+        for (std::size_t i = 0; i < n; i++) {
+            func(i);
+        }
+        return;
+    }
+
+    std::vector<std::future<void>> futures;
+    const detail::wait_all guard(futures);
+    for (std::size_t i = 0; i + 1 < n; i++) {
+        futures.push_back(default_pool().submit([&func, i] { func(i); }));
+    }
+
+    func(n - 1);
+
+    for (auto& f : futures) {
+        f.get();
+    }
+}
+
+// More than one input, or a directory of them, means batch mode
+auto is_batch(int argc, char** argv) -> bool
+{
+    return argc > 2 || (argc == 2 && std::filesystem::is_directory(argv[1]));
+}
+
+// Solves many inputs concurrently on the default pool. Each argument is an
+// input file, or a directory whose regular files (in name order) are inputs.
+// solve(path) returns the result line for one input; lines are streamed to
+// stdout in input order, and the overall throughput is reported on stderr.
+template <typename Solve>
+auto run_batch(std::span<char* const> args, Solve solve) -> int
+{
+    std::vector<std::string> paths;
+    for (const char* arg : args) {
+        if (std::filesystem::is_directory(arg)) {
+            std::vector<std::string> dir_paths;
+            for (auto const& entry : std::filesystem::directory_iterator(arg)) {
+                if (entry.is_regular_file()) {
+                    dir_paths.push_back(entry.path().string());
+                }
+            }
+            std::ranges::sort(dir_paths);
+            paths.insert(paths.end(), dir_paths.begin(), dir_paths.end());
+        } else {
+            paths.emplace_back(arg);
+        }
+    }
+
+    timer t;
+
+    std::vector<std::future<std::string>> results;
+    const detail::wait_all guard(results);
+    for (std::string const& path : paths) {
+        results.push_back(default_pool().submit([&solve, &path] {
+            auto scope = trace_scope(path);
+            if (!std::filesystem::is_regular_file(path)) {
+                throw std::runtime_error("not a readable file");
+            }
+            return std::string(solve(path.c_str()));
+        }));
+    }
+
+    int n_failed = 0;
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        try {
+            fmt::print("{}: {}\n", paths[i], results[i].get());
+        } catch (std::exception const& e) {
+            fmt::print("{}: error: {}\n", paths[i], e.what());
+            ++n_failed;
+        }
+        std::fflush(stdout);
+    }
+
+    const double secs = t.elapsed<std::chrono::duration<double>>().count();
+    fmt::print(stderr, "Solved {} inputs ({} failed) in {:.3f}s on {} threads: {:.1f} inputs/s\n",
+               paths.size(), n_failed, secs, default_pool().size(),
+               secs > 0 ? paths.size() / secs : 0.0);
+
+    return n_failed == 0 ? 0 : 1;
+}
+
+// Compile-time solving. Build with -DAOC_EMBED_INPUT='"path/to/input"' on a
+// compiler supporting #embed, or generate a header containing the input as a
+// string literal with embed_input.sh and build with
+// -DAOC_EMBED_HEADER='"input.inc"'. Days which support it then evaluate their
+// answers entirely during compilation (see constexpr_report.sh).
+#if defined(AOC_EMBED_HEADER)
+#define AOC_HAS_EMBEDDED_INPUT
+constexpr std::string_view embedded_input =
+#include AOC_EMBED_HEADER
+;
+#elif defined(AOC_EMBED_INPUT) && defined(__has_embed)
+#if __has_embed(AOC_EMBED_INPUT)
+#define AOC_HAS_EMBEDDED_INPUT
+namespace detail {
+constexpr char embedded_input_data[] = {
+#embed AOC_EMBED_INPUT
+};
+}
+constexpr std::string_view embedded_input(detail::embedded_input_data,
+                                          sizeof(detail::embedded_input_data));
+#else
+#error "AOC_EMBED_INPUT file not found"
+#endif
+#elif defined(AOC_EMBED_INPUT)
+#error "This compiler lacks #embed: use embed_input.sh and AOC_EMBED_HEADER instead"
+#endif
+
 } // namespace aoc
 
 #endif
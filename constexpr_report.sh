@@ -0,0 +1,50 @@
+#!/bin/sh
+# Reports which days can be solved entirely at compile time within a given
+# constexpr step limit. Each argument pairs a day with its input, e.g.
+#
+#   CXX=g++ ./constexpr_report.sh 100000000 dec01=inputs/dec01.txt dec06=inputs/dec06.txt
+#
+# The limit is passed to GCC as -fconstexpr-ops-limit (and the loop limit),
+# or to Clang as -fconstexpr-steps.
+
+if [ $# -lt 2 ]; then
+    echo "Usage: $0 <step limit> <day>=<input file>..." >&2
+    exit 1
+fi
+
+root=$(cd "$(dirname "$0")" && pwd)
+cxx=${CXX:-c++}
+limit=$1
+shift
+
+if "$cxx" --version | grep -qi clang; then
+    limit_flags="-fconstexpr-steps=$limit"
+else
+    limit_flags="-fconstexpr-ops-limit=$limit -fconstexpr-loop-limit=$limit"
+fi
+
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+for arg in "$@"; do
+    day=${arg%%=*}
+    input=${arg#*=}
+
+    if ! grep -q AOC_HAS_EMBEDDED_INPUT "$root/$day/main.cpp"; then
+        echo "$day: not supported"
+        continue
+    fi
+
+    "$root/embed_input.sh" "$input" "$tmp/$day.inc" || continue
+
+    # shellcheck disable=SC2086
+    if "$cxx" -std=c++20 -O2 $limit_flags -DAOC_EMBED_HEADER="\"$tmp/$day.inc\"" \
+            "$root/$day/main.cpp" -o "$tmp/$day" -pthread 2> "$tmp/$day.log"; then
+        echo "$day: fits ($("$tmp/$day" | tr '\n' ' '))"
+    elif grep -qi "exceeds limit\|maximum step limit\|constexpr-ops-limit\|constexpr-steps" "$tmp/$day.log"; then
+        echo "$day: exceeds limit"
+    else
+        echo "$day: failed to compile (see below)"
+        sed 's/^/    /' "$tmp/$day.log" | head -20
+    fi
+done
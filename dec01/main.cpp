@@ -1,27 +1,207 @@
 
 #include "../common.hpp"
 
-constexpr auto count_increasing = [](int win_sz, const auto& input) {
-    return flow::zip_with(std::greater<>{}, flow::drop(input, win_sz), input)
-                .count(true);
+#include <bit>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Counts the i in [first, last) for which input[i + win_sz] > input[i]
+constexpr auto count_increasing_range = [](std::span<int const> input, std::size_t win_sz,
+                                           std::size_t first, std::size_t last) -> std::int64_t
+{
+    std::int64_t count = 0;
+    std::size_t i = first;
+
+#ifdef __AVX2__
+    if (!std::is_constant_evaluated()) {
+        for (; i + 8 <= last; i += 8) {
+            const auto lo = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(input.data() + i));
+            const auto hi = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(input.data() + i + win_sz));
+            const auto mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(hi, lo)));
+            count += std::popcount(static_cast<unsigned>(mask));
+        }
+    }
+#endif
+
+    for (; i < last; i++) {
+        count += input[i + win_sz] > input[i];
+    }
+
+    return count;
+};
+
+// Each comparison reads from within the window ahead of it, so the input can
+// be split anywhere: a chunk just reads up to win_sz elements past its end
+constexpr auto count_increasing = [](std::size_t win_sz, const auto& input) -> std::int64_t {
+    const auto span = std::span<int const>(input);
+
+    if (span.size() <= win_sz) {
+        return 0;
+    }
+
+    const std::size_t n = span.size() - win_sz;
+
+    if (std::is_constant_evaluated()) {
+        return count_increasing_range(span, win_sz, 0, n);
+    }
+
+    return aoc::parallel_reduce(n, 1 << 18, std::int64_t{0}, [&](std::size_t first, std::size_t last) {
+        return count_increasing_range(span, win_sz, first, last);
+    });
+};
+
+// Counts for every window size over comparison indices [first, last), one
+// cache-sized block at a time: each block (plus the largest window's worth of
+// lookahead) is still hot when the next window size comes to scan it
+constexpr auto count_increasing_multi_range = [](std::span<int const> input,
+                                                 std::span<std::size_t const> win_szs,
+                                                 std::size_t first, std::size_t last)
+    -> std::vector<std::int64_t>
+{
+    constexpr std::size_t block_sz = 4096;
+
+    std::vector<std::int64_t> counts(win_szs.size());
+
+    for (std::size_t block = first; block < last; block += block_sz) {
+        for (std::size_t w = 0; w < win_szs.size(); w++) {
+            if (win_szs[w] >= input.size()) {
+                continue;
+            }
+
+            // Larger windows have fewer comparisons in total
+            const std::size_t end = std::min({block + block_sz, last, input.size() - win_szs[w]});
+            if (block < end) {
+                counts[w] += count_increasing_range(input, win_szs[w], block, end);
+            }
+        }
+    }
+
+    return counts;
+};
+
+// Answers count_increasing for many window sizes with a single (blocked) pass
+// over the input, rather than one full scan per window size
+constexpr auto count_increasing_multi = [](std::span<std::size_t const> win_szs, const auto& input)
+    -> std::vector<std::int64_t>
+{
+    const auto span = std::span<int const>(input);
+
+    const std::size_t min_win = win_szs.empty() ? 0 : std::ranges::min(win_szs);
+    if (span.size() <= min_win) {
+        return std::vector<std::int64_t>(win_szs.size());
+    }
+
+    const std::size_t n = span.size() - min_win;
+
+    if (std::is_constant_evaluated()) {
+        return count_increasing_multi_range(span, win_szs, 0, n);
+    }
+
+    return aoc::parallel_reduce(n, 1 << 18, std::vector<std::int64_t>(win_szs.size()),
+        [&](std::size_t first, std::size_t last) {
+            return count_increasing_multi_range(span, win_szs, first, last);
+        },
+        [](std::vector<std::int64_t> acc, std::vector<std::int64_t> const& counts) {
+            std::ranges::transform(acc, counts, acc.begin(), std::plus<>{});
+            return acc;
+        });
+};
+
+// Incremental count_increasing for live feeds. Only the last K readings are
+// kept (in a ring buffer), and the running count for every window size 1..K
+// is updated as each reading arrives.
+template <std::size_t K>
+class depth_tracker {
+    static_assert(K > 0);
+
+    std::array<int, K> ring_{};
+    std::array<std::int64_t, K> counts_{};
+    std::size_t n_readings_ = 0;
+
+public:
+    constexpr void push(int reading)
+    {
+        const std::size_t pos = n_readings_ % K;
+        const std::size_t max_win = std::min(K, n_readings_);
+
+        for (std::size_t w = 1; w <= max_win; w++) {
+            counts_[w - 1] += reading > ring_[(pos + K - w) % K];
+        }
+
+        ring_[pos] = reading;
+        ++n_readings_;
+    }
+
+    constexpr void push(std::span<int const> readings)
+    {
+        for (int r : readings) {
+            push(r);
+        }
+    }
+
+    constexpr auto count(std::size_t win_sz) const -> std::int64_t
+    {
+        assert(win_sz >= 1 && win_sz <= K);
+        return counts_[win_sz - 1];
+    }
+
+    constexpr auto size() const -> std::size_t { return n_readings_; }
+};
+
+constexpr auto read_input = [](const char* path)
+{
+    return aoc::prefetch_lines(path)
+        .map([](std::string_view line) { return aoc::try_parse<int>(line).value(); })
+        .to_vector();
 };
 
 constexpr auto part1 = std::bind_front(count_increasing, 1);
 constexpr auto part2 = std::bind_front(count_increasing, 3);
 
+// Both parts in a single pass
+constexpr std::array<std::size_t, 2> part_win_szs = {1, 3};
+
 constexpr std::array test_data = {199, 200, 208, 210, 200, 207, 240, 269, 260, 263};
 static_assert(part1(test_data) == 7);
 static_assert(part2(test_data) == 5);
+static_assert(count_increasing_multi(std::array<std::size_t, 4>{1, 3, 9, 10}, test_data)
+                == std::vector<std::int64_t>{7, 5, 1, 0});
+static_assert([] {
+    depth_tracker<3> tracker;
+    tracker.push(std::span(test_data).first(4));
+    tracker.push(std::span(test_data).subspan(4));
+    return std::tuple(tracker.count(1), tracker.count(2), tracker.count(3), tracker.size());
+}() == std::tuple(7, count_increasing(2, test_data), 5, test_data.size()));
 
 int main(int argc, char** argv)
 {
+#ifdef AOC_HAS_EMBEDDED_INPUT
+    {
+        constexpr auto p1 = [] { return part1(aoc::parse_ints(aoc::embedded_input, "\n")); }();
+        constexpr auto p2 = [] { return part2(aoc::parse_ints(aoc::embedded_input, "\n")); }();
+        fmt::print("Part 1: {}\nPart 2: {}\n", p1, p2);
+        return 0;
+    }
+#endif
+
     if (argc < 2) {
         fmt::print(stderr, "No input\n");
         return -1;
     }
 
-    auto const input = aoc::vector_from_file<int>(argv[1]);
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [](const char* path) {
+            auto const input = read_input(path);
+            auto const counts = count_increasing_multi(part_win_szs, input);
+            return fmt::format("{} {}", counts[0], counts[1]);
+        });
+    }
+
+    auto const input = read_input(argv[1]);
+    auto const counts = count_increasing_multi(part_win_szs, input);
 
-    fmt::print("Part 1: {}\n", part1(input));
-    fmt::print("Part 2: {}\n", part2(input));
+    fmt::print("Part 1: {}\n", counts[0]);
+    fmt::print("Part 2: {}\n", counts[1]);
 }
\ No newline at end of file
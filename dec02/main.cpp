@@ -1,41 +1,311 @@
 
 #include "../common.hpp"
 
-constexpr auto part1 = [](std::string_view input) {
-    int horiz = 0;
-    int depth = 0;
+#include <bit>
 
-    aoc::split_string(input, "\n")
-        .for_each([&](auto str) {
-            const auto val = str.back() - '0';
+// The net effect of a run of commands. Starting from (h, d, a), they take us
+// to (h + horiz, d + depth + a * horiz, a + aim): an affine update, and these
+// compose associatively, so a long command log can be summarised in parallel
+// chunks. Summarising from the start of the log gives the submarine's state.
+//
+// Part 1 ignores aim and treats up/down as depth changes, so its depth is
+// exactly the part 2 aim.
+struct summary {
+    std::int64_t horiz = 0;
+    std::int64_t depth = 0;
+    std::int64_t aim = 0;
 
-            switch (str.front()) {
-            case 'f': horiz += val; break;
-            case 'd': depth += val; break;
-            case 'u': depth -= val; break;
-            }
-        });
+    // The effect of applying `*this` and then `next`
+    constexpr auto then(summary const& next) const -> summary
+    {
+        return {.horiz = horiz + next.horiz,
+                .depth = depth + next.depth + aim * next.horiz,
+                .aim = aim + next.aim};
+    }
 
-    return horiz * depth;
+    constexpr bool operator==(summary const&) const = default;
 };
 
-constexpr auto part2 = [](std::string_view input) {
-    int horiz = 0;
-    int depth = 0;
-    int aim = 0;
-
-    aoc::split_string(input, "\n")
-        .for_each([&](auto str) {
-            const auto val = str.back() - '0';
-
-            switch (str.front()) {
-            case 'f': horiz += val; depth += (aim * val); break;
-            case 'd': aim += val; break;
-            case 'u': aim -= val; break;
+// Returns a mask with the high bit set in each byte of `bytes` which is not
+// an ASCII digit. There's no carry between bytes, which is the point.
+constexpr auto non_digit_mask = [](std::uint64_t bytes) -> std::uint64_t {
+    const std::uint64_t d = bytes ^ 0x3030303030303030;
+    return (((d & 0x7F7F7F7F7F7F7F7F) + 0x7676767676767676) | d) & 0x8080808080808080;
+};
+
+// Converts the digits at `pos` (advancing past them), eight at a time where
+// eight bytes are available, combining pairs, then quads, then octets of
+// digits with three multiplies
+constexpr auto parse_amount = [](std::string_view input, std::size_t& pos) -> std::int64_t {
+    std::int64_t val = 0;
+
+    while (pos + 8 <= input.size()) {
+        std::uint64_t bytes = 0;
+        for (int i = 7; i >= 0; i--) {
+            bytes = (bytes << 8) | static_cast<unsigned char>(input[pos + i]);
+        }
+
+        const auto n_digits = std::countr_zero(non_digit_mask(bytes)) / 8;
+        if (n_digits == 0) {
+            return val;
+        }
+
+        // Shift the digits to the top, leaving zero digits below them
+        std::uint64_t v = (bytes & 0x0F0F0F0F0F0F0F0F) << (8 * (8 - n_digits));
+        v = ((v * 10) + (v >> 8)) & 0x00FF00FF00FF00FF;
+        v = ((v * 100) + (v >> 16)) & 0x0000FFFF0000FFFF;
+        v = ((v * 10000) + (v >> 32)) & 0x00000000FFFFFFFF;
+
+        std::int64_t scale = 1;
+        for (int i = 0; i < n_digits; i++) {
+            scale *= 10;
+        }
+
+        val = val * scale + static_cast<std::int64_t>(v);
+        pos += n_digits;
+
+        if (n_digits < 8) {
+            return val;
+        }
+    }
+
+    // Fewer than eight bytes left
+    while (pos < input.size() && input[pos] >= '0' && input[pos] <= '9') {
+        val = val * 10 + (input[pos++] - '0');
+    }
+
+    return val;
+};
+
+// Exactly one of the flags is set, so these updates need no branching
+constexpr auto apply_command = [](summary& s, std::int64_t is_fwd, std::int64_t is_down,
+                                  std::int64_t is_up, std::int64_t val) {
+    s.horiz += is_fwd * val;
+    s.depth += is_fwd * s.aim * val;
+    s.aim += (is_down - is_up) * val;
+};
+
+// Calls func(is_fwd, is_down, is_up, amount) for each command, straight off
+// the raw text with no intermediate tokens. The command is classified by its
+// first byte, which also tells us how long the word is.
+constexpr auto for_each_command = [](std::string_view input, auto func) {
+    std::size_t pos = 0;
+
+    while (pos < input.size()) {
+        const char c = input[pos];
+        const std::int64_t is_fwd = c == 'f';
+        const std::int64_t is_down = c == 'd';
+        const std::int64_t is_up = c == 'u';
+
+        if (is_fwd + is_down + is_up == 0) {
+            // Blank or unrecognised line
+            pos = std::min(input.find('\n', pos), input.size()) + 1;
+            continue;
+        }
+
+        // "forward ", "down ", "up "
+        pos += is_fwd * 8 + is_down * 5 + is_up * 3;
+        func(is_fwd, is_down, is_up, parse_amount(input, pos));
+
+        // Skip the newline (and anything else trailing on the line)
+        while (pos < input.size() && input[pos] != '\n') {
+            ++pos;
+        }
+        ++pos;
+    }
+};
+
+// Runs the commands in `input` starting from state `s`, calling
+// on_command(s) after each one
+constexpr auto run_commands = [](std::string_view input, summary s, auto on_command) -> summary {
+    for_each_command(input, [&](auto is_fwd, auto is_down, auto is_up, auto val) {
+        apply_command(s, is_fwd, is_down, is_up, val);
+        on_command(s);
+    });
+    return s;
+};
+
+constexpr auto summarise = [](std::string_view input) -> summary {
+    return run_commands(input, summary{}, [](summary const&) {});
+};
+
+// The packed binary format: an 8-byte header, then one varint per command.
+// The first byte holds a 2-bit opcode (forward, down, up) and the low five
+// bits of the amount; further bytes hold seven bits each, least significant
+// first. The high bit of each byte is set if another byte follows, so the
+// usual single-digit command fits in one byte.
+constexpr std::string_view encoded_magic = "AOC02BIN";
+
+constexpr auto is_encoded = [](std::string_view input) {
+    return input.starts_with(encoded_magic);
+};
+
+constexpr auto encode_commands = [](std::string_view text) -> std::string {
+    std::string out(encoded_magic);
+
+    for_each_command(text, [&out](auto /*is_fwd*/, auto is_down, auto is_up, std::int64_t val) {
+        auto amount = static_cast<std::uint64_t>(val);
+        const auto opcode = static_cast<std::uint64_t>(is_down + 2 * is_up);
+
+        out.push_back(static_cast<char>(opcode | (amount & 0x1F) << 2 | (amount > 0x1F ? 0x80 : 0)));
+        amount >>= 5;
+
+        while (amount > 0) {
+            out.push_back(static_cast<char>((amount & 0x7F) | (amount > 0x7F ? 0x80 : 0)));
+            amount >>= 7;
+        }
+    });
+
+    return out;
+};
+
+// Runs encoded commands (without the header). The input comes straight from
+// disk, so anything the encoder couldn't have written is rejected.
+constexpr auto run_encoded_commands = [](std::string_view bytes, summary s, auto on_command) -> summary {
+    std::size_t pos = 0;
+
+    while (pos < bytes.size()) {
+        auto b = static_cast<std::uint8_t>(bytes[pos++]);
+        const int opcode = b & 0x3;
+        auto val = static_cast<std::int64_t>((b >> 2) & 0x1F);
+
+        if (opcode == 3) {
+            throw std::runtime_error("Corrupt encoded command: invalid opcode");
+        }
+
+        for (int shift = 5; b & 0x80; shift += 7) {
+            if (pos == bytes.size()) {
+                throw std::runtime_error("Corrupt encoded command: truncated amount");
             }
+            if (shift >= 64) {
+                throw std::runtime_error("Corrupt encoded command: amount is longer than 64 bits");
+            }
+            b = static_cast<std::uint8_t>(bytes[pos++]);
+            const auto bits = static_cast<std::uint64_t>(b & 0x7F);
+            if (shift + 7 > 64 && (bits >> (64 - shift)) != 0) {
+                throw std::runtime_error("Corrupt encoded command: amount is longer than 64 bits");
+            }
+            val |= static_cast<std::int64_t>(bits << shift);
+        }
+
+        apply_command(s, opcode == 0, opcode == 1, opcode == 2, val);
+        on_command(s);
+    }
+
+    return s;
+};
+
+// A chunk of text owns the lines which start within it
+constexpr auto line_start_at_or_after = [](std::string_view input, std::size_t pos) {
+    if (pos == 0) {
+        return pos;
+    }
+    const auto idx = input.find('\n', pos - 1);
+    return idx == input.npos ? input.size() : idx + 1;
+};
+
+// Likewise, a chunk of encoded commands owns the commands starting within it:
+// a command starts after any byte without the continuation bit
+constexpr auto encoded_start_at_or_after = [](std::string_view bytes, std::size_t pos) {
+    if (pos == 0) {
+        return pos;
+    }
+    while (pos - 1 < bytes.size() && (bytes[pos - 1] & 0x80)) {
+        ++pos;
+    }
+    return std::min(pos, bytes.size());
+};
+
+struct text_format {
+    static constexpr auto chunk = [](std::string_view input, std::size_t first, std::size_t last) {
+        const auto start = line_start_at_or_after(input, first);
+        return input.substr(start, line_start_at_or_after(input, last) - start);
+    };
+
+    static constexpr auto run = run_commands;
+};
+
+struct encoded_format {
+    static constexpr auto chunk = [](std::string_view bytes, std::size_t first, std::size_t last) {
+        const auto start = encoded_start_at_or_after(bytes, first);
+        return bytes.substr(start, encoded_start_at_or_after(bytes, last) - start);
+    };
+
+    static constexpr auto run = run_encoded_commands;
+};
+
+// Calls func(format{}, payload) for whichever format `input` is in
+constexpr auto visit_format = [](std::string_view input, auto func) {
+    if (is_encoded(input)) {
+        return func(encoded_format{}, input.substr(encoded_magic.size()));
+    }
+    return func(text_format{}, input);
+};
+
+const auto summarise_parallel = [](std::string_view input) -> summary {
+    return visit_format(input, [](auto format, std::string_view payload) {
+        return aoc::parallel_reduce(payload.size(), 1 << 20, summary{},
+            [format, payload](std::size_t first, std::size_t last) {
+                return format.run(format.chunk(payload, first, last), summary{}, [](summary const&) {});
+            },
+            [](summary const& acc, summary const& next) { return acc.then(next); });
+    });
+};
+
+// The state after every command, as a two-pass parallel scan: summarise each
+// chunk (counting its commands as we go), scan the summaries to find each
+// chunk's starting state and output offset, then replay the chunks from
+// those states in parallel
+const auto trajectory = [](std::string_view input) -> std::vector<summary> {
+    return visit_format(input, [](auto format, std::string_view payload) {
+        const std::size_t n_chunks = aoc::thread_pool::on_worker_thread() ? 1 :
+            std::clamp<std::size_t>(payload.size() / (1 << 20), 1, aoc::default_pool().size() + 1);
+
+        std::vector<std::string_view> chunks(n_chunks);
+        for (std::size_t i = 0; i < n_chunks; i++) {
+            chunks[i] = format.chunk(payload, payload.size() * i / n_chunks,
+                                     payload.size() * (i + 1) / n_chunks);
+        }
+
+        std::vector<summary> starts(n_chunks + 1);
+        std::vector<std::size_t> offsets(n_chunks + 1);
+
+        aoc::parallel_for(n_chunks, [&](std::size_t i) {
+            starts[i + 1] = format.run(chunks[i], summary{}, [&](summary const&) { ++offsets[i + 1]; });
         });
 
-    return horiz * depth;
+        for (std::size_t i = 0; i < n_chunks; i++) {
+            starts[i + 1] = starts[i].then(starts[i + 1]);
+            offsets[i + 1] += offsets[i];
+        }
+
+        std::vector<summary> states(offsets.back());
+
+        aoc::parallel_for(n_chunks, [&](std::size_t i) {
+            auto out = states.begin() + offsets[i];
+            format.run(chunks[i], starts[i], [&out](summary const& s) { *out++ = s; });
+        });
+
+        return states;
+    });
+};
+
+// Memory-maps the input where we can; text and encoded files both work
+const auto summarise_file = [](const char* path) -> summary {
+    if (auto file = aoc::mapped_file(path)) {
+        return summarise_parallel(std::string_view(file.bytes().data(), file.bytes().size()));
+    }
+    return summarise_parallel(aoc::string_from_file(path));
+};
+
+constexpr auto part1 = [](std::string_view input) {
+    const auto s = summarise(input);
+    return s.horiz * s.aim;
+};
+
+constexpr auto part2 = [](std::string_view input) {
+    const auto s = summarise(input);
+    return s.horiz * s.depth;
 };
 
 constexpr std::string_view test_data =
@@ -48,16 +318,77 @@ forward 2)";
 
 static_assert(part1(test_data) == 150);
 static_assert(part2(test_data) == 900);
+static_assert(summarise("forward 1234\ndown 56789\nforward 9876543210\nup 7\n") ==
+              summary{.horiz = 9876544444, .depth = 56789 * 9876543210, .aim = 56782});
+static_assert(summarise("down 5\nforward 8\n").then(summarise("up 3\ndown 8\nforward 2"))
+                == summarise("down 5\nforward 8\nup 3\ndown 8\nforward 2"));
+static_assert(run_encoded_commands(encode_commands(test_data).substr(encoded_magic.size()),
+                                   summary{}, [](summary const&) {}) == summarise(test_data));
+static_assert(encode_commands(test_data).size() == encoded_magic.size() + 6);
 
 int main(int argc, char** argv)
 {
+#ifdef AOC_HAS_EMBEDDED_INPUT
+    {
+        constexpr auto p1 = [] { return part1(aoc::embedded_input); }();
+        constexpr auto p2 = [] { return part2(aoc::embedded_input); }();
+        fmt::print("Part 1: {}\nPart 2: {}\n", p1, p2);
+        return 0;
+    }
+#endif
+
+    {
+        const auto rejects = [](std::string const& bytes) {
+            try {
+                run_encoded_commands(bytes, summary{}, [](summary const&) {});
+            } catch (std::runtime_error const&) {
+                return true;
+            }
+            return false;
+        };
+        const auto max_prefix = "\x80" + std::string(8, '\xff');
+
+        assert(!rejects(max_prefix + '\x07')); // the largest 64-bit amount
+        assert(rejects("\x03"));                // invalid opcode
+        assert(rejects("\x02\x80"));            // truncated amount
+        assert(rejects(max_prefix + '\x08'));   // bit 64 set
+        assert(rejects(max_prefix + "\x87\x00")); // an eleventh byte
+    }
+
+    // After the embedded-input branch: this starts the thread pool
+    {
+        const auto states = trajectory(test_data);
+        assert(states.size() == 6);
+        assert(states.back() == summarise(test_data));
+        assert(trajectory(encode_commands(test_data)) == states);
+    }
+
     if (argc < 2) {
         fmt::print(stderr, "No input\n");
         return -1;
     }
 
-    std::string input = aoc::string_from_file(argv[1]);
+    using namespace std::string_view_literals;
+
+    if (argv[1] == "--encode"sv) {
+        if (argc != 4) {
+            fmt::print(stderr, "Usage: {} --encode <text input> <binary output>\n", argv[0]);
+            return -1;
+        }
+        const auto encoded = encode_commands(aoc::string_from_file(argv[2]));
+        std::ofstream(argv[3], std::ios::binary).write(encoded.data(), encoded.size());
+        return 0;
+    }
+
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [](const char* path) {
+            const auto s = summarise_file(path);
+            return fmt::format("{} {}", s.horiz * s.aim, s.horiz * s.depth);
+        });
+    }
+
+    const auto s = summarise_file(argv[1]);
 
-    fmt::print("Part 1: {}\n", part1(input));
-    fmt::print("Part 2: {}\n", part2(input));
+    fmt::print("Part 1: {}\n", s.horiz * s.aim);
+    fmt::print("Part 2: {}\n", s.horiz * s.depth);
 }
\ No newline at end of file
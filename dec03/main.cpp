@@ -3,15 +3,9 @@
 
 using namespace std::string_view_literals;
 
-constexpr auto parse_input = [](const char* path)
-{
-    auto file = std::ifstream(path);
-    return aoc::lines(file).to_vector();
-};
-
 constexpr auto bstring_to_uint = [](std::string_view str)
 {
-    std::uint32_t u = 0;
+    std::uint64_t u = 0;
     for (char c : str) {
         u *= 2;
         u += c == '1' ? 1 : 0;
@@ -19,20 +13,128 @@ constexpr auto bstring_to_uint = [](std::string_view str)
     return u;
 };
 
-template <int Bits>
-constexpr auto part1 = [](auto const& input) {
-    uint32_t gamma = 0;
-    uint32_t epsilon = 0;
+// Diagnostics are lines of '0's and '1's, all the same width. Strips any
+// trailing '\r' (from CRLF files) and checks the line against the width seen
+// so far (or sets it, if this is the first line), throwing rather than
+// guessing if anything is off.
+constexpr auto check_diagnostic = [](std::string_view line, int& width) -> std::string_view
+{
+    if (line.ends_with('\r')) {
+        line.remove_suffix(1);
+    }
 
-    for (int b = 0; b < Bits; b++) {
-        gamma *= 2;
-        epsilon *= 2;
+    if (line.find_first_not_of("01") != line.npos) {
+        throw std::runtime_error(fmt::format("Unexpected character in diagnostic '{}'", line));
+    }
+
+    if (width < 0) {
+        width = static_cast<int>(line.size());
+        if (width > 64) {
+            throw std::runtime_error(fmt::format("Diagnostics are {} bits wide, the limit is 64", width));
+        }
+    } else if (static_cast<int>(line.size()) != width) {
+        throw std::runtime_error(fmt::format("Diagnostic '{}' is not {} bits wide", line, width));
+    }
+
+    return line;
+};
+
+// Returns the packed diagnostics (see pack_input()) and their width. Blank
+// lines are skipped.
+constexpr auto parse_diagnostics = [](auto&& lines)
+{
+    std::vector<std::uint64_t> words;
+    int width = -1;
+
+    lines.for_each([&](std::string_view line) {
+        if (!line.empty() && line != "\r") {
+            words.push_back(bstring_to_uint(check_diagnostic(line, width)));
+        }
+    });
 
-        auto n_ones = flow::count_if(input, [b] (std::string_view val) {
-            return  val[b] == '1';
+    return std::pair(std::move(words), std::max(width, 0));
+};
+
+constexpr auto parse_input = [](const char* path)
+{
+    return parse_diagnostics(aoc::prefetch_lines(path));
+};
+
+// Each diagnostic as a word, with the first column in the most significant
+// of the used bits
+constexpr auto pack_input = [](auto const& input) -> std::vector<std::uint64_t>
+{
+    std::vector<std::uint64_t> words;
+    words.reserve(input.size());
+    for (std::string_view str : input) {
+        words.push_back(bstring_to_uint(str));
+    }
+    return words;
+};
+
+using column_counts_t = std::array<std::int64_t, 64>;
+
+// Counts the set bits in each bit position of the words, in one pass. The
+// words are added into bit-sliced ("vertical") counters: plane p holds bit p
+// of every position's count, so a ripple-carry add of a word updates all 64
+// counters at once, and usually stops after a plane or two. The planes are
+// flushed into ordinary counts just before they could overflow.
+constexpr auto column_counts = [](std::span<std::uint64_t const> words) -> column_counts_t
+{
+    constexpr int n_planes = 8;
+    constexpr std::size_t flush_every = (1u << n_planes) - 1;
+
+    column_counts_t counts{};
+    std::array<std::uint64_t, n_planes> planes{};
+
+    auto flush = [&] {
+        for (int p = 0; p < n_planes; p++) {
+            for (int col = 0; col < 64; col++) {
+                counts[col] += static_cast<std::int64_t>((planes[p] >> col) & 1) << p;
+            }
+            planes[p] = 0;
+        }
+    };
+
+    for (std::size_t i = 0; i < words.size(); i++) {
+        std::uint64_t carry = words[i];
+        for (int p = 0; p < n_planes && carry != 0; p++) {
+            const std::uint64_t next = planes[p] & carry;
+            planes[p] ^= carry;
+            carry = next;
+        }
+
+        if ((i + 1) % flush_every == 0) {
+            flush();
+        }
+    }
+
+    flush();
+    return counts;
+};
+
+const auto column_counts_parallel = [](std::span<std::uint64_t const> words) -> column_counts_t
+{
+    return aoc::parallel_reduce(words.size(), 1 << 20, column_counts_t{},
+        [words](std::size_t first, std::size_t last) {
+            return column_counts(words.subspan(first, last - first));
+        },
+        [](column_counts_t acc, column_counts_t const& counts) {
+            std::ranges::transform(acc, counts, acc.begin(), std::plus<>{});
+            return acc;
         });
+};
+
+constexpr auto power_consumption = [](column_counts_t const& counts, std::size_t n_words, int bits)
+{
+    std::uint64_t gamma = 0;
+    std::uint64_t epsilon = 0;
+
+    for (int b = bits - 1; b >= 0; b--) {
+        gamma *= 2;
+        epsilon *= 2;
 
-        if (n_ones >= input.size()/2) {
+        if (static_cast<std::size_t>(counts[b]) >= n_words/2) {
             gamma += 1;
         } else {
             epsilon += 1;
@@ -43,56 +145,128 @@ constexpr auto part1 = [](auto const& input) {
 };
 
 template <int Bits>
-constexpr auto part2 = [](auto input) {
+constexpr auto part1 = [](auto const& input) {
+    return power_consumption(column_counts(pack_input(input)), input.size(), Bits);
+};
 
-    auto sub = std::ranges::subrange(input);
+// A binary trie over the diagnostics, most significant bit first, counting
+// the values below each node. The oxygen and CO2 ratings are then just
+// O(width) walks from the root, for any width up to 64, and values can be
+// added at any time. A subtree holding a single value is kept as one leaf
+// node until a second value arrives, which saves most of the nodes.
+class rating_trie {
+    struct node {
+        std::array<std::uint32_t, 2> child{};
+        std::uint64_t count = 0;
+        std::uint64_t value = 0;
+    };
 
-    for (int b = 0; b < Bits; b++) {
-        if (sub.size() == 1) {
-            break;
-        }
+    int width_;
+    // Node 0 is the root, so a zero child index means no child
+    std::vector<node> nodes_ = std::vector<node>(1);
+
+    constexpr auto is_leaf(std::uint32_t n) const -> bool
+    {
+        return nodes_[n].child[0] == 0 && nodes_[n].child[1] == 0;
+    }
 
-        auto check1 = [b] (std::string_view val) { return val[b] == '1'; };
+    constexpr auto count_of(std::uint32_t n) const -> std::uint64_t
+    {
+        return n == 0 ? 0 : nodes_[n].count;
+    }
 
-        // Count the 1s
-        auto n_ones = flow::count_if(sub, check1);
+    constexpr auto add_leaf(std::uint64_t value, std::uint64_t count) -> std::uint32_t
+    {
+        nodes_.push_back(node{.count = count, .value = value});
+        return static_cast<std::uint32_t>(nodes_.size() - 1);
+    }
 
-        if (n_ones >= (sub.size() - n_ones)) {
-            auto out = std::ranges::partition(sub, check1);
-            sub = std::ranges::subrange(sub.begin(), out.begin());
-        } else {
-            auto out = std::ranges::partition(sub, std::not_fn(check1));
-            sub = std::ranges::subrange(sub.begin(), out.begin());
+    // Follows the more (or less) common bit at each level, preferring 1 (or
+    // 0) on ties, until only one distinct value remains
+    constexpr auto walk(bool most_common) const -> std::uint64_t
+    {
+        assert(size() > 0);
+
+        std::uint32_t n = 0;
+        while (!is_leaf(n)) {
+            const auto n0 = count_of(nodes_[n].child[0]);
+            const auto n1 = count_of(nodes_[n].child[1]);
+            const int bit = n0 == 0 ? 1 :
+                            n1 == 0 ? 0 :
+                            most_common ? n1 >= n0 : n1 < n0;
+            n = nodes_[n].child[bit];
         }
+        return nodes_[n].value;
     }
 
-    auto oxygen = bstring_to_uint(sub[0]);
+public:
+    constexpr explicit rating_trie(int width)
+        : width_(width)
+    {
+        assert(width >= 1 && width <= 64);
+    }
 
-    /// and again
-    sub = std::ranges::subrange(input);
+    constexpr void insert(std::uint64_t value)
+    {
+        std::uint32_t n = 0;
 
-    for (int b = 0; b < Bits; b++) {
-        if (sub.size() == 1) {
-            break;
-        }
+        for (int b = width_ - 1; ; b--) {
+            if (nodes_[n].count == 0) {
+                nodes_[n].value = value;
+                nodes_[n].count = 1;
+                return;
+            }
 
-        auto check1 = [b] (std::string_view val) { return val[b] == '1'; };
+            // At full depth, every value here is the same
+            if (b < 0) {
+                ++nodes_[n].count;
+                return;
+            }
 
-        // Count the 1s
-        auto n_ones = flow::count_if(sub, check1);
+            // Push a single-value leaf down a level to make room
+            if (is_leaf(n)) {
+                const auto old = nodes_[n].value;
+                const auto child = add_leaf(old, nodes_[n].count);
+                nodes_[n].child[(old >> b) & 1] = child;
+            }
 
-        if (n_ones >= (sub.size() - n_ones)) {
-            auto out = std::ranges::partition(sub, std::not_fn(check1));
-            sub = std::ranges::subrange(sub.begin(), out.begin());
-        } else {
-            auto out = std::ranges::partition(sub, check1);
-            sub = std::ranges::subrange(sub.begin(), out.begin());
+            ++nodes_[n].count;
+
+            const int bit = (value >> b) & 1;
+            if (nodes_[n].child[bit] == 0) {
+                const auto child = add_leaf(value, 1);
+                nodes_[n].child[bit] = child;
+                return;
+            }
+
+            n = nodes_[n].child[bit];
+        }
+    }
+
+    constexpr void insert(std::span<std::uint64_t const> values)
+    {
+        for (auto v : values) {
+            insert(v);
         }
     }
 
-    auto co2 = bstring_to_uint(sub[0]);
+    constexpr auto size() const -> std::uint64_t { return nodes_[0].count; }
+
+    constexpr auto oxygen_rating() const -> std::uint64_t { return walk(true); }
 
-    return oxygen * co2;
+    constexpr auto co2_rating() const -> std::uint64_t { return walk(false); }
+};
+
+constexpr auto life_support_rating = [](std::span<std::uint64_t const> words, int bits)
+{
+    rating_trie trie(bits);
+    trie.insert(words);
+    return trie.oxygen_rating() * trie.co2_rating();
+};
+
+template <int Bits>
+constexpr auto part2 = [](auto const& input) {
+    return life_support_rating(pack_input(input), Bits);
 };
 
 constexpr std::array test_data = {
@@ -111,16 +285,56 @@ constexpr std::array test_data = {
 
 static_assert(part1<5>(test_data) == 198);
 static_assert(part2<5>(test_data) == 230);
+static_assert(parse_diagnostics(aoc::split_string("00100\r\n11110\r\n", "\n")) ==
+              std::pair(std::vector<std::uint64_t>{0b00100, 0b11110}, 5));
+static_assert([] {
+    std::vector<std::uint64_t> words(1000, 0b101);
+    words.push_back(~std::uint64_t{0});
+    auto counts = column_counts(words);
+    return std::tuple(counts[0], counts[1], counts[2], counts[63]);
+}() == std::tuple(1001, 1, 1001, 1));
+static_assert([] {
+    // Built up incrementally, with duplicates
+    rating_trie trie(5);
+    trie.insert(pack_input(std::span(test_data).first(6)));
+    trie.insert(pack_input(std::span(test_data).subspan(6)));
+    trie.insert(pack_input(std::span(test_data).subspan(6)));
+    return std::pair(trie.oxygen_rating(), trie.co2_rating());
+}() == std::pair<std::uint64_t, std::uint64_t>(0b11100, 0b01111));
 
 int main(int argc, char** argv)
 {
+#ifdef AOC_HAS_EMBEDDED_INPUT
+    {
+        // Checked just as at run time: a bad input fails to compile
+        constexpr auto p1 = [] {
+            const auto [words, width] = parse_diagnostics(aoc::split_string(aoc::embedded_input, "\n"));
+            return power_consumption(column_counts(words), words.size(), width);
+        }();
+        constexpr auto p2 = [] {
+            const auto [words, width] = parse_diagnostics(aoc::split_string(aoc::embedded_input, "\n"));
+            return life_support_rating(words, width);
+        }();
+        fmt::print("Part 1: {}\nPart 2: {}\n", p1, p2);
+        return 0;
+    }
+#endif
+
     if (argc < 2) {
         fmt::print(stderr, "No input\n");
         return -1;
     }
 
-    const auto input = parse_input(argv[1]);
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [](const char* path) {
+            const auto [words, width] = parse_input(path);
+            return fmt::format("{} {}", power_consumption(column_counts_parallel(words), words.size(), width),
+                               life_support_rating(words, width));
+        });
+    }
+
+    const auto [words, width] = parse_input(argv[1]);
 
-    fmt::print("Part 1: {}\n", part1<12>(input));
-    fmt::print("Part 2: {}\n", part2<12>(input));
+    fmt::print("Part 1: {}\n", power_consumption(column_counts_parallel(words), words.size(), width));
+    fmt::print("Part 2: {}\n", life_support_rating(words, width));
 }
\ No newline at end of file
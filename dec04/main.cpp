@@ -1,101 +1,368 @@
 
 #include "../common.hpp"
 
+#include <bit>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+
+// Just the numbers: each strategy below keeps its own marking state, so a
+// vector of boards is one flat array of 25 ints per board
 struct board {
+    std::array<int, 25> numbers;
+};
 
-    explicit board(std::string_view vals)
+// Plays all the boards at once. An inverted index maps each number to the
+// (board, cell) positions where it appears, and every board keeps a hit
+// counter per row and column, so each draw costs O(cells containing it)
+// rather than O(boards).
+class bingo_engine {
+    std::size_t n_boards_;
+    // The positions (board * 25 + cell) holding number n are
+    // positions_[offsets_[n]] to positions_[offsets_[n + 1]], in board order
+    std::vector<std::uint32_t> offsets_;
+    std::vector<std::uint32_t> positions_;
+    std::vector<int> board_sums_;
+
+public:
+    explicit bingo_engine(std::span<board const> boards)
+        : n_boards_(boards.size()),
+          board_sums_(boards.size())
     {
-        std::istringstream iss{std::string(vals)};
-        flow::from_istream<int>(iss).output_to(numbers.begin());
+        int max_number = -1;
+        for (auto const& b : boards) {
+            max_number = std::max(max_number, std::ranges::max(b.numbers));
+        }
+
+        // Counting sort of the positions by number
+        offsets_.assign(max_number + 2, 0);
+        for (auto const& b : boards) {
+            for (int n : b.numbers) {
+                ++offsets_[n + 1];
+            }
+        }
+        std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+
+        positions_.resize(offsets_.back());
+        auto next = offsets_;
+        for (std::size_t i = 0; i < boards.size(); i++) {
+            for (std::size_t cell = 0; cell < 25; cell++) {
+                positions_[next[boards[i].numbers[cell]]++] = i * 25 + cell;
+            }
+            board_sums_[i] = flow::sum(boards[i].numbers);
+        }
     }
 
-    bool mark(int number) {
-        auto iter = std::ranges::find(numbers, number);
-        if (iter != numbers.end()) {
-            marked.at(iter - numbers.begin()) = true;
-        } else {
-            return false;
+    // Calls on_win(board_idx, number, score) as each board wins, in the
+    // order that they win (and in board order for boards winning on the same
+    // number). Repeated draws of a number are ignored.
+    template <typename OnWin>
+    void play(std::span<int const> numbers, OnWin on_win) const
+    {
+        const std::size_t n_numbers = offsets_.size() - 1;
+
+        // Per board: hits in rows 0-4, then columns 0-4
+        std::vector<std::array<std::uint8_t, 10>> hits(n_boards_);
+        std::vector<int> unmarked = board_sums_;
+        std::vector<bool> won(n_boards_);
+        std::vector<bool> drawn(n_numbers);
+
+        for (int num : numbers) {
+            if (num < 0 || static_cast<std::size_t>(num) >= n_numbers || drawn[num]) {
+                continue;
+            }
+            drawn[num] = true;
+
+            for (std::uint32_t i = offsets_[num]; i < offsets_[num + 1]; i++) {
+                const std::size_t b = positions_[i] / 25;
+                const std::size_t cell = positions_[i] % 25;
+                if (won[b]) {
+                    continue;
+                }
+
+                unmarked[b] -= num;
+                const bool row_done = ++hits[b][cell / 5] == 5;
+                const bool col_done = ++hits[b][5 + cell % 5] == 5;
+
+                if (row_done || col_done) {
+                    won[b] = true;
+                    on_win(b, num, unmarked[b]);
+                }
+            }
         }
+    }
+};
 
-        // check marked rows
-        bool won = flow::chunk(marked, 5)
-            .map([](auto chunk) { return std::move(chunk).all(flow::pred::eq(true)); })
-            .any(flow::pred::eq(true));
+// The final scores of the first and last boards to win
+constexpr auto play_tournament = [](std::span<int const> numbers, std::span<board const> boards)
+    -> std::pair<flow::maybe<int>, flow::maybe<int>>
+{
+    flow::maybe<int> first;
+    flow::maybe<int> last;
 
-        if (won) {
-            return true;
+    bingo_engine(boards).play(numbers, [&](std::size_t, int number, int score) {
+        if (!first) {
+            first = number * score;
         }
+        last = number * score;
+    });
 
-        // Check marked cols
-        return flow::ints(0, 5)
-                .map([&](int i) {
-                    return flow::drop(marked, i).stride(5).all(flow::pred::eq(true));
-                })
-                .any(flow::pred::eq(true));
+    return {first, last};
+};
+
+// Alternatively, with no simulation at all: if rank[n] is the index of the
+// draw which calls n, a line is complete at the latest rank among its
+// numbers, and a board wins at the earliest of its lines' completion times.
+// Boards share no state, so this is embarrassingly parallel.
+constexpr int never_drawn = std::numeric_limits<int>::max();
+
+constexpr auto draw_ranks = [](std::span<int const> numbers, std::span<board const> boards)
+{
+    int max_number = -1;
+    for (auto const& b : boards) {
+        max_number = std::max(max_number, std::ranges::max(b.numbers));
     }
 
-    int calculate_score() const
-    {
-        return flow::zip(numbers, marked)
-            .filter([](auto p) { return !p.second; })
-            .keys()
-            .sum();
+    std::vector<int> rank(max_number + 1, never_drawn);
+    for (std::size_t i = 0; i < numbers.size(); i++) {
+        const int num = numbers[i];
+        if (num >= 0 && num <= max_number && rank[num] == never_drawn) {
+            rank[num] = static_cast<int>(i);
+        }
     }
+    return rank;
+};
 
-    std::array<int, 25> numbers;
-    std::array<bool, 25> marked{};
+constexpr auto win_time = [](board const& b, std::span<int const> rank) -> int
+{
+    std::array<int, 10> line_times{};
+    for (std::size_t cell = 0; cell < 25; cell++) {
+        const int r = rank[b.numbers[cell]];
+        line_times[cell / 5] = std::max(line_times[cell / 5], r);
+        line_times[5 + cell % 5] = std::max(line_times[5 + cell % 5], r);
+    }
+    return std::ranges::min(line_times);
 };
 
-constexpr auto parse_input = [](std::string_view input) {
+const auto play_by_win_times = [](std::span<int const> numbers, std::span<board const> boards)
+    -> std::pair<flow::maybe<int>, flow::maybe<int>>
+{
+    const auto rank = draw_ranks(numbers, boards);
 
-    auto first_newline = input.find('\n');
+    // Ties go to the earlier board for the first winner, and to the later
+    // board for the last winner, as in play_tournament()
+    struct winners {
+        std::pair<int, std::size_t> first{never_drawn, 0};
+        std::pair<int, std::size_t> last{-1, 0};
+    };
 
-    auto numbers = aoc::split_string(input.substr(0, first_newline), ",")
-        .map([](std::string_view sv) {
-            return aoc::try_parse<int>(sv).value();
-        })
-        .to_vector();
+    const auto result = aoc::parallel_reduce(boards.size(), 1 << 14, winners{},
+        [&](std::size_t lo, std::size_t hi) {
+            winners w;
+            for (std::size_t i = lo; i < hi; i++) {
+                const int t = win_time(boards[i], rank);
+                if (t == never_drawn) {
+                    continue;
+                }
+                w.first = std::min(w.first, std::pair(t, i));
+                w.last = std::max(w.last, std::pair(t, i));
+            }
+            return w;
+        },
+        [](winners const& a, winners const& b) {
+            return winners{std::min(a.first, b.first), std::max(a.last, b.last)};
+        });
 
-    auto boards = aoc::split_string(input.substr(first_newline + 1), "\n\n")
-        .map([](std::string_view sv) {
-            return board(sv);
-        })
-        .to_vector();
+    auto score = [&](std::pair<int, std::size_t> winner) -> flow::maybe<int> {
+        auto [t, idx] = winner;
+        if (t < 0 || t == never_drawn) {
+            return {};
+        }
+        const int unmarked = flow::filter(boards[idx].numbers, [&](int n) { return rank[n] > t; }).sum();
+        return numbers[t] * unmarked;
+    };
 
-    return std::pair(std::move(numbers), std::move(boards));
+    return {score(result.first), score(result.last)};
 };
 
-constexpr auto part1 = [](const std::vector<int> numbers, std::vector<board> boards)
-    -> flow::maybe<int>
-{
-    return flow::cartesian_product(numbers, boards)
-        .filter([](auto p) { return p.second.mark(p.first) == true; })
-        .next()
-        .map([](auto p) { return p.first * p.second.calculate_score(); });
+// For direct simulation: a board as bytes, padded so that one AVX2 compare
+// marks every cell holding a number, and a bitmask of the marked cells. Win
+// detection is then a test against the ten row and column masks.
+struct packed_board {
+    static constexpr std::uint32_t all_cells = (1u << 25) - 1;
+
+    static constexpr auto win_masks = [] {
+        std::array<std::uint32_t, 10> masks{};
+        for (int i = 0; i < 5; i++) {
+            masks[i] = 0b11111u << (5 * i);
+            masks[5 + i] = 0b00001'00001'00001'00001'00001u << i;
+        }
+        return masks;
+    }();
+
+    alignas(32) std::array<std::uint8_t, 32> numbers{};
+    std::uint32_t marked = 0;
+
+    packed_board() = default;
+
+    explicit packed_board(board const& b)
+    {
+        for (std::size_t i = 0; i < 25; i++) {
+            if (b.numbers[i] < 0 || b.numbers[i] > 255) {
+                throw std::runtime_error(fmt::format("Board number {} won't fit in a byte", b.numbers[i]));
+            }
+            numbers[i] = static_cast<std::uint8_t>(b.numbers[i]);
+        }
+    }
+
+    auto cells_holding(std::uint8_t number) const -> std::uint32_t
+    {
+#ifdef __AVX2__
+        const auto cells = _mm256_load_si256(reinterpret_cast<__m256i const*>(numbers.data()));
+        const auto eq = _mm256_cmpeq_epi8(cells, _mm256_set1_epi8(static_cast<char>(number)));
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(eq)) & all_cells;
+#else
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < 25; i++) {
+            mask |= std::uint32_t{numbers[i] == number} << i;
+        }
+        return mask;
+#endif
+    }
+
+    auto has_won() const -> bool
+    {
+        return std::ranges::any_of(win_masks, [this](std::uint32_t m) { return (marked & m) == m; });
+    }
+
+    // Returns whether this draw made the board win
+    auto mark(std::uint8_t number) -> bool
+    {
+        const auto hits = cells_holding(number);
+        marked |= hits;
+        return hits != 0 && has_won();
+    }
+
+    auto score() const -> int
+    {
+        const std::uint32_t unmarked = ~marked & all_cells;
+#ifdef __AVX2__
+        // Expand the unmarked bits into a byte mask: byte i takes bit i % 8
+        // of mask byte i / 8. Then sum the selected bytes with SAD.
+        const auto bytes = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(unmarked)),
+            _mm256_setr_epi64x(0x0000000000000000, 0x0101010101010101,
+                               0x0202020202020202, 0x0303030303030303));
+        const auto bits = _mm256_set1_epi64x(static_cast<long long>(0x8040201008040201));
+        const auto selected = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, bits), bits);
+        const auto cells = _mm256_load_si256(reinterpret_cast<__m256i const*>(numbers.data()));
+        const auto sums = _mm256_sad_epu8(_mm256_and_si256(cells, selected), _mm256_setzero_si256());
+        const auto sum128 = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+        return static_cast<int>(_mm_cvtsi128_si64(sum128) + _mm_extract_epi64(sum128, 1));
+#else
+        int sum = 0;
+        for (std::size_t i = 0; i < 25; i++) {
+            sum += ((unmarked >> i) & 1) * numbers[i];
+        }
+        return sum;
+#endif
+    }
 };
 
-constexpr auto part2 = [](const std::vector<int>& numbers, std::vector<board> boards) -> flow::maybe<int>
+// Straightforward simulation, marking every live board on each draw
+const auto play_packed = [](std::span<int const> numbers, std::span<board const> boards)
+    -> std::pair<flow::maybe<int>, flow::maybe<int>>
 {
-    std::vector<bool> eliminated(boards.size(), false);
+    auto packed = flow::map(boards, [](board const& b) { return packed_board(b); })
+                    .to_vector();
+    std::vector<bool> won(packed.size());
 
-    for (int i : numbers) {
-        for (int n = 0; n < boards.size(); n++) {
-            if (eliminated[n]) {
-                continue;
-            }
+    flow::maybe<int> first;
+    flow::maybe<int> last;
 
-            if (boards[n].mark(i)) {
-                eliminated[n] = true;
+    for (int num : numbers) {
+        if (num < 0 || num > 255) {
+            continue;
+        }
+
+        for (std::size_t i = 0; i < packed.size(); i++) {
+            if (!won[i] && packed[i].mark(static_cast<std::uint8_t>(num))) {
+                won[i] = true;
+                if (!first) {
+                    first = num * packed[i].score();
+                }
+                last = num * packed[i].score();
             }
+        }
+    }
+
+    return {first, last};
+};
+
+// A single pass over the text, straight into the draws and a flat board
+// store: no per-board allocations, no streams
+constexpr auto parse_input = [](std::string_view input) {
+    std::vector<int> numbers;
+    std::vector<board> boards;
+
+    // A board takes at least 5 lines of 14 characters, usually 15
+    boards.reserve(input.size() / 75 + 1);
 
-            if (flow::all(eliminated, flow::pred::eq(true))) {
-                return {i * boards[n].calculate_score()};
+    std::size_t pos = 0;
+
+    auto is_digit = [&] { return input[pos] >= '0' && input[pos] <= '9'; };
+
+    auto read_number = [&] {
+        int n = 0;
+        while (pos < input.size() && is_digit()) {
+            n = 10 * n + (input[pos++] - '0');
+        }
+        return n;
+    };
+
+    // The draws are the first line
+    while (pos < input.size() && input[pos] != '\n') {
+        if (is_digit()) {
+            numbers.push_back(read_number());
+        } else {
+            ++pos;
+        }
+    }
+
+    // ...and the rest of the numbers fill the boards, 25 at a time
+    board current;
+    std::size_t cell = 0;
+
+    while (pos < input.size()) {
+        if (is_digit()) {
+            current.numbers[cell++] = read_number();
+            if (cell == 25) {
+                boards.push_back(current);
+                cell = 0;
             }
+        } else {
+            ++pos;
         }
     }
 
-    return {};
+    if (cell != 0) {
+        throw std::runtime_error(fmt::format("Incomplete board at end of input ({} numbers)", cell));
+    }
+
+    return std::pair(std::move(numbers), std::move(boards));
+};
+
+constexpr auto part1 = [](std::span<int const> numbers, std::span<board const> boards)
+    -> flow::maybe<int>
+{
+    return play_tournament(numbers, boards).first;
+};
+
+constexpr auto part2 = [](std::span<int const> numbers, std::span<board const> boards)
+    -> flow::maybe<int>
+{
+    return play_tournament(numbers, boards).second;
 };
 
 constexpr std::string_view test_input =
@@ -125,11 +392,30 @@ int main(int argc, char** argv)
         auto const [nums, boards] = parse_input(test_input);
         assert(part1(nums, boards).value() == 4512);
         assert(part2(nums, boards).value() == 1924);
+        auto const [first, last] = play_by_win_times(nums, boards);
+        assert(first.value() == 4512 && last.value() == 1924);
+        auto const [first_packed, last_packed] = play_packed(nums, boards);
+        assert(first_packed.value() == 4512 && last_packed.value() == 1924);
+    }
+
+    if (argc < 2) {
+        fmt::print(stderr, "No input\n");
+        return -1;
+    }
+
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [](const char* path) {
+            auto const input = aoc::string_from_file(path);
+            auto const [numbers, boards] = aoc::cached_parse("dec04", 1, input, parse_input);
+            auto const [first, last] = play_by_win_times(numbers, boards);
+            return fmt::format("{} {}", first.value(), last.value());
+        });
     }
 
     auto const input = aoc::string_from_file(argv[1]);
-    auto const [numbers, boards] = parse_input(input);
+    auto const [numbers, boards] = aoc::cached_parse("dec04", 1, input, parse_input);
+    auto const [first, last] = play_by_win_times(numbers, boards);
 
-    fmt::print("Part 1: {}\n", part1(numbers, boards).value());
-    fmt::print("Part 2: {}\n", part2(numbers, boards).value());
+    fmt::print("Part 1: {}\n", first.value());
+    fmt::print("Part 2: {}\n", last.value());
 }
\ No newline at end of file
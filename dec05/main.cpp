@@ -1,8 +1,15 @@
 
 #include "../common.hpp"
 
+#include <bit>
 #include <cmath>
 #include <compare>
+#include <optional>
+#include <set>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 struct coord {
     int x;
@@ -30,32 +37,26 @@ constexpr auto parse_input = [](std::string_view input)
         .to_vector();
 };
 
-constexpr auto part1 = [](const auto& lines)
-{
-    std::map<coord, int> counts;
+constexpr auto is_axis_aligned = [](line const& l) {
+    return l.from.x == l.to.x || l.from.y == l.to.y;
+};
 
-    for (auto const& line : lines) {
-        if (line.from.x == line.to.x) {
-            auto [miny, maxy] = std::ranges::minmax(line.from.y, line.to.y);
-            for (int y = miny; y <= maxy; y++) {
-                ++counts[{line.from.x, y}];
-            }
-        } else if (line.from.y == line.to.y) {
-            auto [minx, maxx] = std::ranges::minmax(line.from.x, line.to.x);
-            for (int x = minx; x <= maxx; x++) {
-                ++counts[{x, line.to.y}];
-            }
+// Calls func(l) for each line that counts: diagonals are only wanted in part 2
+constexpr auto for_each_line = [](std::span<line const> lines, bool diagonals, auto func) {
+    for (auto const& l : lines) {
+        if (diagonals || is_axis_aligned(l)) {
+            func(l);
         }
     }
-
-    return flow::values(counts).count_if(flow::pred::gt(1));
 };
 
-constexpr auto part2 = [](const auto& lines)
+// Counts points covered more than once by walking every point of every line
+// into a std::map. Slow, but copes with any coordinate range.
+const auto count_overlaps_sparse = [](std::span<line const> lines, bool diagonals) -> std::int64_t
 {
     std::map<coord, int> counts;
 
-    for (auto const& line : lines) {
+    for_each_line(lines, diagonals, [&counts](line const& line) {
         int xinc = std::clamp(line.to.x - line.from.x, -1, 1);
         int yinc = std::clamp(line.to.y - line.from.y, -1, 1);
 
@@ -65,11 +66,546 @@ constexpr auto part2 = [](const auto& lines)
         for (int i = 0; i <= steps; i++) {
             ++counts[{line.from.x + i * xinc, line.from.y + i * yinc}];
         }
-    }
+    });
 
     return flow::values(counts).count_if(flow::pred::gt(1));
 };
 
+// Coverage counts for every point in the lines' bounding box, as saturating
+// bytes: all we care about is whether a count is above 1
+struct coverage_grid {
+    int x0 = 0;
+    int y0 = 0;
+    std::size_t width = 0;
+    std::size_t height = 0;
+    std::vector<std::uint8_t> cells;
+
+    auto index(int x, int y) const -> std::size_t
+    {
+        return static_cast<std::size_t>(y - y0) * width + static_cast<std::size_t>(x - x0);
+    }
+};
+
+// Beyond this we fall back to the sparse counter
+constexpr std::size_t max_grid_cells = std::size_t{1} << 30;
+
+// Adds one to each of n consecutive cells, 32 at a time where we can
+const auto increment_run = [](std::uint8_t* cells, std::size_t n) {
+#ifdef __AVX2__
+    const auto ones = _mm256_set1_epi8(1);
+    for (; n >= 32; n -= 32, cells += 32) {
+        const auto v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(cells));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(cells), _mm256_adds_epu8(v, ones));
+    }
+#endif
+    for (; n > 0; --n, ++cells) {
+        *cells += *cells != 255;
+    }
+};
+
+const auto count_overlapping_cells = [](std::span<std::uint8_t const> cells) -> std::int64_t {
+    std::int64_t count = 0;
+    std::size_t i = 0;
+#ifdef __AVX2__
+    const auto twos = _mm256_set1_epi8(2);
+    for (; i + 32 <= cells.size(); i += 32) {
+        const auto v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(cells.data() + i));
+        // min(v, 2) == 2 exactly when v > 1, using unsigned comparison
+        const auto gt1 = _mm256_cmpeq_epi8(_mm256_min_epu8(v, twos), twos);
+        count += std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(gt1)));
+    }
+#endif
+    for (; i < cells.size(); i++) {
+        count += cells[i] > 1;
+    }
+    return count;
+};
+
+// The lines' bounding box, as an empty grid. Returns nothing if it's too big
+// to be worth rasterising.
+const auto bounding_grid = [](std::span<line const> lines, bool diagonals) -> std::optional<coverage_grid>
+{
+    int min_x = std::numeric_limits<int>::max(), max_x = std::numeric_limits<int>::min();
+    int min_y = min_x, max_y = max_x;
+
+    for_each_line(lines, diagonals, [&](line const& l) {
+        min_x = std::min({min_x, l.from.x, l.to.x});
+        max_x = std::max({max_x, l.from.x, l.to.x});
+        min_y = std::min({min_y, l.from.y, l.to.y});
+        max_y = std::max({max_y, l.from.y, l.to.y});
+    });
+
+    coverage_grid grid;
+    if (min_x > max_x) {
+        return grid;
+    }
+
+    grid.x0 = min_x;
+    grid.y0 = min_y;
+    grid.width = static_cast<std::size_t>(std::int64_t{max_x} - min_x + 1);
+    grid.height = static_cast<std::size_t>(std::int64_t{max_y} - min_y + 1);
+
+    if (grid.width > max_grid_cells / grid.height) {
+        return {};
+    }
+
+    return grid;
+};
+
+const auto rasterise = [](std::span<line const> lines, bool diagonals) -> std::optional<coverage_grid>
+{
+    auto grid = bounding_grid(lines, diagonals);
+    if (!grid) {
+        return {};
+    }
+
+    grid->cells.resize(grid->width * grid->height);
+
+    for_each_line(lines, diagonals, [&grid = *grid](line const& l) {
+        if (l.from.y == l.to.y) {
+            auto [x1, x2] = std::minmax(l.from.x, l.to.x);
+            increment_run(grid.cells.data() + grid.index(x1, l.from.y), x2 - x1 + 1);
+            return;
+        }
+
+        const int xinc = std::clamp(l.to.x - l.from.x, -1, 1);
+        const int yinc = std::clamp(l.to.y - l.from.y, -1, 1);
+        const int steps = std::max(std::abs(l.from.x - l.to.x), std::abs(l.from.y - l.to.y));
+        const auto stride = static_cast<std::ptrdiff_t>(yinc * static_cast<std::ptrdiff_t>(grid.width) + xinc);
+
+        std::uint8_t* cell = grid.cells.data() + grid.index(l.from.x, l.from.y);
+        for (int i = 0; i <= steps; i++, cell += stride) {
+            *cell += *cell != 255;
+        }
+    });
+
+    return grid;
+};
+
+// Counts of overlapping points in rectangles of a rasterised grid, in O(1)
+// each, from a summed-area table of the count > 1 indicator
+struct overlap_density {
+    int x0 = 0;
+    int y0 = 0;
+    std::size_t width = 0;
+    std::size_t height = 0;
+    // sums[(y + 1) * (width + 1) + (x + 1)] counts overlaps in [0, x] x [0, y]
+    std::vector<std::uint32_t> sums;
+
+    explicit overlap_density(coverage_grid const& grid)
+        : x0(grid.x0), y0(grid.y0), width(grid.width), height(grid.height),
+          sums((width + 1) * (height + 1))
+    {
+        const auto stride = width + 1;
+        for (std::size_t y = 0; y < height; y++) {
+            std::uint32_t row = 0;
+            for (std::size_t x = 0; x < width; x++) {
+                row += grid.cells[y * width + x] > 1;
+                sums[(y + 1) * stride + x + 1] = sums[y * stride + x + 1] + row;
+            }
+        }
+    }
+
+    // Overlapping points in [x_lo, x_hi] x [y_lo, y_hi], inclusive. Parts of
+    // the rectangle outside the grid are ignored.
+    auto overlaps_in(int x_lo, int y_lo, int x_hi, int y_hi) const -> std::int64_t
+    {
+        const auto clamp_to = [](std::int64_t v, std::size_t size) {
+            return static_cast<std::size_t>(std::clamp<std::int64_t>(v, 0, static_cast<std::int64_t>(size)));
+        };
+        // Half-open bounds in local coordinates
+        const auto xa = clamp_to(std::int64_t{x_lo} - x0, width);
+        const auto xb = clamp_to(std::int64_t{x_hi} - x0 + 1, width);
+        const auto ya = clamp_to(std::int64_t{y_lo} - y0, height);
+        const auto yb = clamp_to(std::int64_t{y_hi} - y0 + 1, height);
+
+        if (xa >= xb || ya >= yb) {
+            return 0;
+        }
+
+        const auto stride = width + 1;
+        return std::int64_t{sums[yb * stride + xb]} - sums[ya * stride + xb]
+               - sums[yb * stride + xa] + sums[ya * stride + xa];
+    }
+
+    struct rect {
+        coord lo;
+        coord hi;
+    };
+
+    auto overlaps_in(std::span<rect const> rects) const -> std::vector<std::int64_t>
+    {
+        // Each query is four lookups: far too little work to hand to the pool
+        std::vector<std::int64_t> out(rects.size());
+        std::ranges::transform(rects, out.begin(), [this](rect const& r) {
+            return overlaps_in(r.lo.x, r.lo.y, r.hi.x, r.hi.y);
+        });
+        return out;
+    }
+};
+
+// For big fields, we split the bounding box into tiles small enough to stay
+// in cache, bin each line into runs of cells within the tiles it crosses,
+// then count every tile independently on the thread pool
+constexpr int tile_shift = 8;
+constexpr int tile_size = 1 << tile_shift;
+
+// A line's run of cells within a single tile, in tile-local coordinates
+struct tile_run {
+    std::uint8_t x;
+    std::uint8_t y;
+    std::int8_t xinc;
+    std::int8_t yinc;
+    std::uint16_t len;
+};
+
+const auto count_overlaps_tiled = [](std::span<line const> lines, bool diagonals, coverage_grid const& bounds)
+    -> std::int64_t
+{
+    const auto tiles_x = (bounds.width + tile_size - 1) >> tile_shift;
+    const auto tiles_y = (bounds.height + tile_size - 1) >> tile_shift;
+    std::vector<std::vector<tile_run>> bins(tiles_x * tiles_y);
+
+    for_each_line(lines, diagonals, [&](line l) {
+        // Walk horizontal lines left to right so their runs are contiguous
+        if (l.from.y == l.to.y && l.from.x > l.to.x) {
+            std::swap(l.from, l.to);
+        }
+
+        const int xinc = std::clamp(l.to.x - l.from.x, -1, 1);
+        const int yinc = std::clamp(l.to.y - l.from.y, -1, 1);
+        const std::int64_t steps = std::max(std::abs(std::int64_t{l.from.x} - l.to.x),
+                                            std::abs(std::int64_t{l.from.y} - l.to.y));
+        const std::int64_t x0 = std::int64_t{l.from.x} - bounds.x0;
+        const std::int64_t y0 = std::int64_t{l.from.y} - bounds.y0;
+
+        for (std::int64_t i = 0; i <= steps; ) {
+            const auto x = x0 + i * xinc, y = y0 + i * yinc;
+            const auto lx = x & (tile_size - 1), ly = y & (tile_size - 1);
+
+            // How many more steps until we leave the tile in each direction
+            const std::int64_t to_edge_x = xinc > 0 ? tile_size - 1 - lx : xinc < 0 ? lx : tile_size;
+            const std::int64_t to_edge_y = yinc > 0 ? tile_size - 1 - ly : yinc < 0 ? ly : tile_size;
+            const auto len = std::min({to_edge_x, to_edge_y, steps - i}) + 1;
+
+            auto& bin = bins[static_cast<std::size_t>(y >> tile_shift) * tiles_x +
+                             static_cast<std::size_t>(x >> tile_shift)];
+            bin.push_back({static_cast<std::uint8_t>(lx), static_cast<std::uint8_t>(ly),
+                           static_cast<std::int8_t>(xinc), static_cast<std::int8_t>(yinc),
+                           static_cast<std::uint16_t>(len)});
+            i += len;
+        }
+    });
+
+    return aoc::parallel_reduce(bins.size(), 4, std::int64_t{0}, [&bins](std::size_t first, std::size_t last) {
+        std::vector<std::uint8_t> cells(tile_size * tile_size);
+        std::int64_t count = 0;
+
+        for (std::size_t t = first; t < last; t++) {
+            if (bins[t].size() < 2) {
+                continue; // a single run can't overlap itself
+            }
+
+            std::ranges::fill(cells, 0);
+            for (auto [x, y, xinc, yinc, len] : bins[t]) {
+                std::uint8_t* cell = cells.data() + y * tile_size + x;
+                if (yinc == 0) {
+                    increment_run(cell, len);
+                    continue;
+                }
+
+                const int stride = yinc * tile_size + xinc;
+                for (int i = 0; i < len; i++, cell += stride) {
+                    *cell += *cell != 255;
+                }
+            }
+            count += count_overlapping_cells(cells);
+        }
+
+        return count;
+    });
+};
+
+// For huge, sparse coordinate spaces we count overlaps without visiting
+// points at all. Each line belongs to one of four families by direction, and
+// is an inclusive interval of a parameter t at a fixed key:
+//
+//   horizontal:    key y,     t = x
+//   vertical:      key x,     t = y
+//   diagonal:      key x - y, t = x
+//   anti-diagonal: key x + y, t = x
+//
+// Within a family, overlaps come from interval arithmetic on lines sharing a
+// key. Across families, they're the points where the families' lines cross.
+namespace sweep {
+
+enum family { horizontal, vertical, diagonal, anti_diagonal, n_families };
+
+struct interval {
+    std::int64_t lo;
+    std::int64_t hi;
+};
+
+// Sorted, disjoint intervals for each key
+using interval_map = std::map<std::int64_t, std::vector<interval>>;
+
+struct point {
+    std::int64_t x;
+    std::int64_t y;
+
+    auto operator<=>(const point&) const = default;
+};
+
+constexpr auto key_of = [](family f, point p) -> std::int64_t {
+    switch (f) {
+    case horizontal: return p.y;
+    case vertical: return p.x;
+    case diagonal: return p.x - p.y;
+    case anti_diagonal: return p.x + p.y;
+    default: return 0;
+    }
+};
+
+constexpr auto param_of = [](family f, point p) -> std::int64_t {
+    return f == vertical ? p.y : p.x;
+};
+
+constexpr auto point_at = [](family f, std::int64_t key, std::int64_t t) -> point {
+    switch (f) {
+    case horizontal: return {t, key};
+    case vertical: return {key, t};
+    case diagonal: return {t, t - key};
+    case anti_diagonal: return {t, key - t};
+    default: return {};
+    }
+};
+
+constexpr auto family_of = [](line const& l) -> family {
+    const int dx = l.to.x - l.from.x;
+    const int dy = l.to.y - l.from.y;
+
+    if (dy == 0) {
+        return horizontal;
+    } else if (dx == 0) {
+        return vertical;
+    } else if (dx == dy) {
+        return diagonal;
+    } else if (dx == -dy) {
+        return anti_diagonal;
+    }
+    throw std::runtime_error("Lines must be horizontal, vertical or at 45 degrees");
+};
+
+struct family_coverage {
+    interval_map covered;   // by at least one line
+    interval_map overlaps;  // by at least two lines
+};
+
+// The parts of the key's line covered by at least one and at least two of
+// the intervals, via a sweep over the interval end points
+constexpr auto add_coverage = [](family_coverage& cov, std::int64_t key, std::vector<interval> const& ivs)
+{
+    std::vector<std::pair<std::int64_t, int>> events;
+    for (auto [lo, hi] : ivs) {
+        events.emplace_back(lo, 1);
+        events.emplace_back(hi + 1, -1);
+    }
+    std::ranges::sort(events);
+
+    auto append = [key](interval_map& map, std::int64_t lo, std::int64_t hi) {
+        auto& out = map[key];
+        if (!out.empty() && out.back().hi + 1 == lo) {
+            out.back().hi = hi;
+        } else {
+            out.push_back({lo, hi});
+        }
+    };
+
+    int depth = 0;
+    for (std::size_t i = 0; i < events.size(); ) {
+        const auto pos = events[i].first;
+        for (; i < events.size() && events[i].first == pos; i++) {
+            depth += events[i].second;
+        }
+
+        if (i < events.size()) {
+            const auto end = events[i].first - 1;
+            if (depth >= 1) {
+                append(cov.covered, pos, end);
+            }
+            if (depth >= 2) {
+                append(cov.overlaps, pos, end);
+            }
+        }
+    }
+};
+
+constexpr auto contains = [](interval_map const& map, std::int64_t key, std::int64_t t) -> bool {
+    auto it = map.find(key);
+    if (it == map.end()) {
+        return false;
+    }
+    auto iv = std::ranges::upper_bound(it->second, t, {}, &interval::lo);
+    return iv != it->second.begin() && std::prev(iv)->hi >= t;
+};
+
+// A coordinate system p = px*x + py*y, q = qx*x + qy*y
+struct axes {
+    std::int64_t px, py, qx, qy;
+};
+
+// A segment with fixed `fixed` coordinate, spanning [lo, hi] in the other
+struct segment {
+    std::int64_t fixed;
+    std::int64_t lo;
+    std::int64_t hi;
+};
+
+// Converts the covered intervals of a family to segments in `ax` (in which
+// the family must be axis-aligned), with p fixed if fixed_p, else q fixed
+constexpr auto to_segments = [](interval_map const& covered, family f, axes ax, bool fixed_p)
+{
+    std::vector<segment> segs;
+    for (auto const& [key, ivs] : covered) {
+        for (auto [lo, hi] : ivs) {
+            const auto a = point_at(f, key, lo);
+            const auto b = point_at(f, key, hi);
+            const auto pa = ax.px * a.x + ax.py * a.y, pb = ax.px * b.x + ax.py * b.y;
+            const auto qa = ax.qx * a.x + ax.qy * a.y, qb = ax.qx * b.x + ax.qy * b.y;
+            if (fixed_p) {
+                segs.push_back({pa, std::min(qa, qb), std::max(qa, qb)});
+            } else {
+                segs.push_back({qa, std::min(pa, pb), std::max(pa, pb)});
+            }
+        }
+    }
+    return segs;
+};
+
+// Every crossing of a row (q fixed) with a column (p fixed) which is a
+// lattice point in the original coordinates, by sweeping along p with the
+// active rows kept ordered by q
+constexpr auto crossings = [](std::vector<segment> const& rows, std::vector<segment> const& cols,
+                              axes ax, std::vector<point>& out)
+{
+    // At equal p: open rows, then query columns, then close rows
+    std::vector<std::tuple<std::int64_t, int, std::size_t>> events;
+    for (std::size_t i = 0; i < rows.size(); i++) {
+        events.emplace_back(rows[i].lo, 0, i);
+        events.emplace_back(rows[i].hi, 2, i);
+    }
+    for (std::size_t i = 0; i < cols.size(); i++) {
+        events.emplace_back(cols[i].fixed, 1, i);
+    }
+    std::ranges::sort(events);
+
+    const auto det = ax.px * ax.qy - ax.py * ax.qx;
+    std::multiset<std::int64_t> active;
+
+    for (auto [p, type, i] : events) {
+        if (type == 0) {
+            active.insert(rows[i].fixed);
+        } else if (type == 2) {
+            active.erase(active.find(rows[i].fixed));
+        } else {
+            const auto& col = cols[i];
+            for (auto it = active.lower_bound(col.lo); it != active.end() && *it <= col.hi; ++it) {
+                const auto q = *it;
+                const auto xn = ax.qy * p - ax.py * q;
+                const auto yn = ax.px * q - ax.qx * p;
+                if (xn % det == 0 && yn % det == 0) {
+                    out.push_back({xn / det, yn / det});
+                }
+            }
+        }
+    }
+};
+
+constexpr auto count_overlaps = [](std::span<line const> lines, bool diagonals) -> std::int64_t
+{
+    // Group each family's lines by key
+    std::array<std::map<std::int64_t, std::vector<interval>>, n_families> groups;
+
+    for_each_line(lines, diagonals, [&groups](line const& l) {
+        const auto f = family_of(l);
+        const point a{l.from.x, l.from.y};
+        const point b{l.to.x, l.to.y};
+        const auto ta = param_of(f, a);
+        const auto tb = param_of(f, b);
+        groups[f][key_of(f, a)].push_back({std::min(ta, tb), std::max(ta, tb)});
+    });
+
+    std::array<family_coverage, n_families> cov;
+    std::int64_t total = 0;
+
+    for (int f = 0; f < n_families; f++) {
+        for (auto const& [key, ivs] : groups[f]) {
+            add_coverage(cov[f], key, ivs);
+        }
+        for (auto const& [key, ivs] : cov[f].overlaps) {
+            for (auto [lo, hi] : ivs) {
+                total += hi - lo + 1;
+            }
+        }
+    }
+
+    // For each pair of families, axes in which the first runs along p (as
+    // rows) and the second along q (as columns)
+    constexpr std::array<std::tuple<family, family, axes>, 6> pairs = {{
+        {horizontal, vertical, {1, 0, 0, 1}},
+        {horizontal, diagonal, {1, -1, 0, 1}},
+        {horizontal, anti_diagonal, {1, 1, 0, 1}},
+        {vertical, diagonal, {1, -1, 1, 0}},
+        {vertical, anti_diagonal, {1, 1, 1, 0}},
+        {diagonal, anti_diagonal, {1, 1, 1, -1}},
+    }};
+
+    std::vector<point> crossing_points;
+    for (auto [f, g, ax] : pairs) {
+        if (!cov[f].covered.empty() && !cov[g].covered.empty()) {
+            crossings(to_segments(cov[f].covered, f, ax, false),
+                      to_segments(cov[g].covered, g, ax, true), ax, crossing_points);
+        }
+    }
+
+    std::ranges::sort(crossing_points);
+    const auto [last, end] = std::ranges::unique(crossing_points);
+    crossing_points.erase(last, end);
+
+    // A crossing is covered at least twice. It has already been counted once
+    // for each family in which it's an overlap: it should count once in all.
+    for (auto const& pt : crossing_points) {
+        std::int64_t n_counted = 0;
+        for (int f = 0; f < n_families; f++) {
+            const auto fam = static_cast<family>(f);
+            n_counted += contains(cov[f].overlaps, key_of(fam, pt), param_of(fam, pt));
+        }
+        total += n_counted == 0 ? 1 : 1 - n_counted;
+    }
+
+    return total;
+};
+
+}
+
+const auto count_overlaps = [](std::span<line const> lines, bool diagonals) -> std::int64_t
+{
+    if (auto bounds = bounding_grid(lines, diagonals)) {
+        return count_overlaps_tiled(lines, diagonals, *bounds);
+    }
+    return sweep::count_overlaps(lines, diagonals);
+};
+
+const auto part1 = [](std::span<line const> lines)
+{
+    return count_overlaps(lines, false);
+};
+
+const auto part2 = [](std::span<line const> lines)
+{
+    return count_overlaps(lines, true);
+};
+
 constexpr std::string_view test_data =
 R"(0,9 -> 5,9
 8,0 -> 0,8
@@ -88,10 +624,36 @@ int main(int argc, char** argv)
         const auto lines = parse_input(test_data);
         assert(part1(lines) == 5);
         assert(part2(lines) == 12);
+        assert(count_overlaps_sparse(lines, false) == 5);
+        assert(count_overlaps_sparse(lines, true) == 12);
+        assert(sweep::count_overlaps(lines, false) == 5);
+        assert(sweep::count_overlaps(lines, true) == 12);
+        assert(count_overlapping_cells(rasterise(lines, true)->cells) == 12);
+
+        const overlap_density density(*rasterise(lines, true));
+        assert(density.overlaps_in(0, 0, 9, 9) == 12);
+        assert(density.overlaps_in(-100, -100, 100, 100) == 12);
+        assert(density.overlaps_in(0, 4, 9, 4) == 4);
+        assert(density.overlaps_in(5, 5, 4, 4) == 0);
+        const std::array<overlap_density::rect, 2> rects{{{{2, 2}, {2, 2}}, {{0, 0}, {5, 3}}}};
+        assert((density.overlaps_in(rects) == std::vector<std::int64_t>{1, 2}));
+    }
+
+    if (argc < 2) {
+        fmt::print(stderr, "No input\n");
+        return -1;
+    }
+
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [](const char* path) {
+            const auto input = aoc::string_from_file(path);
+            const auto lines = aoc::cached_parse("dec05", 1, input, parse_input);
+            return fmt::format("{} {}", part1(lines), part2(lines));
+        });
     }
 
     const auto input = aoc::string_from_file(argv[1]);
-    const auto lines = parse_input(input);
+    const auto lines = aoc::cached_parse("dec05", 1, input, parse_input);
 
     fmt::print("Part 1: {}\n", part1(lines));
     fmt::print("Part 2: {}\n", part2(lines));
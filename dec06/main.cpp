@@ -1,6 +1,8 @@
 
 #include "../common.hpp"
 
+#include <bit>
+
 constexpr auto read_vector = [](const char* filename) -> std::vector<int>
 {
     std::vector<int> vec;
@@ -35,15 +37,402 @@ constexpr std::array test_data = { 3, 4, 3, 1, 2 };
 static_assert(process(test_data, 80) == 5934);
 static_assert(process(test_data, 256) == 26984457539);
 
+// Growth is linear in the initial counts, so the answer for any school is the
+// sum over timers of count[t] * growth[t], where growth[t] is the population
+// a single fish with timer t grows into
+using timer_counts = std::array<std::int64_t, 9>;
+using growth_table = std::array<std::int64_t, 9>;
+
+constexpr auto make_growth_table = [](int days) -> growth_table
+{
+    growth_table table{};
+    for (int t = 0; t < 9; t++) {
+        table[t] = process(std::array{t}, days);
+    }
+    return table;
+};
+
+template <int Days>
+constexpr growth_table growth_after = make_growth_table(Days);
+
+constexpr auto count_timers = [](const auto& input) -> timer_counts
+{
+    timer_counts counts{};
+    for (int i : input) {
+        ++counts[i];
+    }
+    return counts;
+};
+
+constexpr auto apply_growth = [](growth_table const& table, timer_counts const& counts) -> std::int64_t
+{
+    std::int64_t total = 0;
+    for (int t = 0; t < 9; t++) {
+        total += counts[t] * table[t];
+    }
+    return total;
+};
+
+// Answers many schools at once, with nine multiply-adds each
+const auto apply_growth_batch = [](growth_table const& table, std::span<timer_counts const> schools)
+{
+    std::vector<std::int64_t> out(schools.size());
+    std::ranges::transform(schools, out.begin(), [&table](timer_counts const& counts) {
+        return apply_growth(table, counts);
+    });
+    return out;
+};
+
+static_assert(apply_growth(growth_after<80>, count_timers(test_data)) == 5934);
+static_assert(apply_growth(growth_after<256>, count_timers(test_data)) == 26984457539);
+
+// For very long horizons, we raise the one-day transition matrix to the
+// power of the number of days by repeated squaring, in O(log days). Counts
+// can be any type with +, * and construction from an integer: __int128 lasts
+// about a thousand days, mod_int for ever, and big_uint as long as memory does.
+
+// Counts modulo the prime P
+template <std::uint64_t P>
+struct mod_int {
+    std::uint64_t value = 0;
+
+    constexpr mod_int() = default;
+    constexpr mod_int(std::uint64_t v) : value(v % P) {}
+
+    friend constexpr auto operator+(mod_int a, mod_int b) -> mod_int
+    {
+        return mod_int(a.value + b.value);
+    }
+
+    friend constexpr auto operator*(mod_int a, mod_int b) -> mod_int
+    {
+        return mod_int(static_cast<std::uint64_t>(static_cast<unsigned __int128>(a.value) * b.value % P));
+    }
+
+    friend constexpr bool operator==(mod_int, mod_int) = default;
+};
+
+// A minimal arbitrary-precision unsigned integer, as base 2^32 limbs with the
+// least significant first
+struct big_uint {
+    std::vector<std::uint32_t> limbs;
+
+    constexpr big_uint() = default;
+
+    constexpr big_uint(std::uint64_t v)
+    {
+        for (; v != 0; v >>= 32) {
+            limbs.push_back(static_cast<std::uint32_t>(v));
+        }
+    }
+
+    friend constexpr auto operator+(big_uint const& a, big_uint const& b) -> big_uint
+    {
+        auto const& longer = a.limbs.size() >= b.limbs.size() ? a : b;
+        auto const& shorter = a.limbs.size() >= b.limbs.size() ? b : a;
+
+        big_uint out;
+        std::uint64_t carry = 0;
+        for (std::size_t i = 0; i < longer.limbs.size(); i++) {
+            carry += longer.limbs[i];
+            if (i < shorter.limbs.size()) {
+                carry += shorter.limbs[i];
+            }
+            out.limbs.push_back(static_cast<std::uint32_t>(carry));
+            carry >>= 32;
+        }
+        if (carry != 0) {
+            out.limbs.push_back(static_cast<std::uint32_t>(carry));
+        }
+        return out;
+    }
+
+    friend constexpr auto operator*(big_uint const& a, big_uint const& b) -> big_uint
+    {
+        if (a.limbs.empty() || b.limbs.empty()) {
+            return {};
+        }
+
+        big_uint out;
+        out.limbs.resize(a.limbs.size() + b.limbs.size());
+        for (std::size_t i = 0; i < a.limbs.size(); i++) {
+            std::uint64_t carry = 0;
+            for (std::size_t j = 0; j < b.limbs.size(); j++) {
+                carry += std::uint64_t{a.limbs[i]} * b.limbs[j] + out.limbs[i + j];
+                out.limbs[i + j] = static_cast<std::uint32_t>(carry);
+                carry >>= 32;
+            }
+            out.limbs[i + b.limbs.size()] = static_cast<std::uint32_t>(carry);
+        }
+        while (!out.limbs.empty() && out.limbs.back() == 0) {
+            out.limbs.pop_back();
+        }
+        return out;
+    }
+
+    friend constexpr bool operator==(big_uint const&, big_uint const&) = default;
+
+    // Decimal digits, by repeated division by 10^9
+    auto to_string() const -> std::string
+    {
+        if (limbs.empty()) {
+            return "0";
+        }
+
+        auto rest = limbs;
+        std::vector<std::uint32_t> chunks;
+        while (!rest.empty()) {
+            std::uint64_t rem = 0;
+            for (auto i = rest.size(); i-- > 0; ) {
+                const auto cur = (rem << 32) | rest[i];
+                rest[i] = static_cast<std::uint32_t>(cur / 1'000'000'000);
+                rem = cur % 1'000'000'000;
+            }
+            chunks.push_back(static_cast<std::uint32_t>(rem));
+            while (!rest.empty() && rest.back() == 0) {
+                rest.pop_back();
+            }
+        }
+
+        std::string out;
+        for (auto i = chunks.size(); i-- > 0; ) {
+            auto digits = std::to_string(chunks[i]);
+            if (i + 1 != chunks.size()) {
+                out.append(9 - digits.size(), '0');
+            }
+            out += digits;
+        }
+        return out;
+    }
+};
+
+// A square matrix of size n, stored row-major
+template <typename T>
+struct square_matrix {
+    std::size_t n;
+    std::vector<T> cells;
+
+    constexpr explicit square_matrix(std::size_t size) : n(size), cells(size * size, T(0)) {}
+
+    static constexpr auto identity(std::size_t size) -> square_matrix
+    {
+        square_matrix m(size);
+        for (std::size_t i = 0; i < size; i++) {
+            m(i, i) = T(1);
+        }
+        return m;
+    }
+
+    constexpr auto operator()(std::size_t i, std::size_t j) -> T& { return cells[i * n + j]; }
+    constexpr auto operator()(std::size_t i, std::size_t j) const -> T const& { return cells[i * n + j]; }
+};
+
+template <typename T>
+constexpr auto multiply(square_matrix<T> const& a, square_matrix<T> const& b) -> square_matrix<T>
+{
+    square_matrix<T> out(a.n);
+    for (std::size_t i = 0; i < a.n; i++) {
+        for (std::size_t k = 0; k < a.n; k++) {
+            for (std::size_t j = 0; j < a.n; j++) {
+                out(i, j) = out(i, j) + a(i, k) * b(k, j);
+            }
+        }
+    }
+    return out;
+}
+
+template <typename T>
+constexpr auto matrix_power(square_matrix<T> base, std::uint64_t exp) -> square_matrix<T>
+{
+    auto result = square_matrix<T>::identity(base.n);
+
+    for (; exp != 0; exp >>= 1) {
+        if (exp & 1) {
+            result = multiply(result, base);
+        }
+        if (exp > 1) {
+            base = multiply(base, base);
+        }
+    }
+    return result;
+}
+
+// A species' timers reset to cycle - 1 after spawning, with newborns starting
+// newborn_delay days later still. Lanternfish are {7, 2}; other species vary.
+struct lifecycle {
+    int cycle;
+    int newborn_delay;
+
+    constexpr auto slots() const -> std::size_t
+    {
+        return static_cast<std::size_t>(cycle + newborn_delay);
+    }
+};
+
+constexpr lifecycle lanternfish{7, 2};
+
+// The one-day step, as counts_new[i] = sum over j of m(i, j) * counts[j]
+template <typename T>
+constexpr auto transition_matrix(lifecycle lc) -> square_matrix<T>
+{
+    const auto n = lc.slots();
+    square_matrix<T> m(n);
+    for (std::size_t i = 0; i + 1 < n; i++) {
+        m(i, i + 1) = T(1); // timers count down...
+    }
+    m(lc.cycle - 1, 0) = m(lc.cycle - 1, 0) + T(1); // ...fish at zero reset...
+    m(n - 1, 0) = m(n - 1, 0) + T(1);               // ...and spawn a newborn
+    return m;
+}
+
+template <typename T>
+constexpr auto process_log(const auto& input, std::uint64_t days) -> T
+{
+    std::array<std::uint64_t, 9> counts{};
+    for (int i : input) {
+        ++counts[i];
+    }
+
+    const auto m = matrix_power(transition_matrix<T>(lanternfish), days);
+
+    T total(0);
+    for (std::size_t i = 0; i < 9; i++) {
+        for (std::size_t j = 0; j < 9; j++) {
+            total = total + m(i, j) * T(counts[j]);
+        }
+    }
+    return total;
+}
+
+static_assert(process_log<std::int64_t>(test_data, 80) == 5934);
+static_assert(process_log<__int128>(test_data, 256) == 26984457539);
+static_assert(process_log<mod_int<1'000'000'007>>(test_data, 256) == mod_int<1'000'000'007>(26984457539));
+
+// Populations of one species are stored structure-of-arrays style, as
+// counts[timer * n_populations + p], so each day's update is a single
+// contiguous (and vectorisable) row addition across every population
+
+// Simulates day by day with a rotating buffer, in O(days * populations)
+template <typename T = std::int64_t>
+constexpr auto lifecycle_rotate(lifecycle lc, std::span<T const> counts, std::size_t n_populations,
+                                std::uint64_t days) -> std::vector<T>
+{
+    const auto n = lc.slots();
+    std::vector<T> buf(counts.begin(), counts.end());
+
+    for (std::uint64_t i = 0; i < days; i++) {
+        T const* src = buf.data() + (i % n) * n_populations;
+        T* dst = buf.data() + ((i + lc.cycle) % n) * n_populations;
+        for (std::size_t p = 0; p < n_populations; p++) {
+            dst[p] = dst[p] + src[p];
+        }
+    }
+
+    std::vector<T> totals(n_populations, T(0));
+    for (std::size_t slot = 0; slot < n; slot++) {
+        for (std::size_t p = 0; p < n_populations; p++) {
+            totals[p] = totals[p] + buf[slot * n_populations + p];
+        }
+    }
+    return totals;
+}
+
+// Raises the species' transition matrix to the number of days, in
+// O(slots^3 log days), then weights each population's counts by the column
+// sums of the result: slots multiply-adds per population
+template <typename T = std::int64_t>
+constexpr auto lifecycle_power(lifecycle lc, std::span<T const> counts, std::size_t n_populations,
+                               std::uint64_t days) -> std::vector<T>
+{
+    const auto n = lc.slots();
+    const auto m = matrix_power(transition_matrix<T>(lc), days);
+
+    std::vector<T> totals(n_populations, T(0));
+    for (std::size_t j = 0; j < n; j++) {
+        T weight(0);
+        for (std::size_t i = 0; i < n; i++) {
+            weight = weight + m(i, j);
+        }
+        for (std::size_t p = 0; p < n_populations; p++) {
+            totals[p] = totals[p] + weight * counts[j * n_populations + p];
+        }
+    }
+    return totals;
+}
+
+// Total population of each of n_populations after the given number of days,
+// by whichever method needs fewer operations
+template <typename T = std::int64_t>
+constexpr auto lifecycle_totals(lifecycle lc, std::span<T const> counts, std::size_t n_populations,
+                                std::uint64_t days) -> std::vector<T>
+{
+    if (lc.cycle < 1 || lc.newborn_delay < 0) {
+        throw std::runtime_error("Lifecycles need a cycle of at least one day and a non-negative delay");
+    }
+    if (counts.size() != lc.slots() * n_populations) {
+        throw std::runtime_error("Expected one count per timer for each population");
+    }
+
+    const auto n = lc.slots();
+    const auto power_cost = 2 * n * n * n * std::bit_width(days) + n * n_populations;
+    if (days * n_populations <= power_cost) {
+        return lifecycle_rotate<T>(lc, counts, n_populations, days);
+    }
+    return lifecycle_power<T>(lc, counts, n_populations, days);
+}
+
+static_assert([] {
+    const auto counts = count_timers(test_data);
+    const auto n = lifecycle_rotate<std::int64_t>(lanternfish, counts, 1, 256)[0];
+    const auto m = lifecycle_power<std::int64_t>(lanternfish, counts, 1, 256)[0];
+    return n == 26984457539 && m == n;
+}());
+
+// Two populations of a species with a five day cycle and three day delay
+static_assert([] {
+    const std::array<std::int64_t, 16> counts = {1, 0, 2, 1, 0, 0, 3, 0, 0, 4, 0, 0, 1, 0, 0, 2};
+    for (std::uint64_t days : {0, 1, 5, 17, 100}) {
+        if (lifecycle_rotate<std::int64_t>({5, 3}, counts, 2, days) !=
+            lifecycle_power<std::int64_t>({5, 3}, counts, 2, days)) {
+            return false;
+        }
+    }
+    return lifecycle_totals<std::int64_t>({5, 3}, counts, 2, 0) == std::vector<std::int64_t>{7, 7};
+}());
 int main(int argc, char** argv)
 {
+#ifdef AOC_HAS_EMBEDDED_INPUT
+    {
+        constexpr auto counts = count_timers(aoc::parse_ints(aoc::embedded_input, ","));
+        constexpr auto p1 = apply_growth(growth_after<80>, counts);
+        constexpr auto p2 = apply_growth(growth_after<256>, counts);
+        fmt::print("Part 1: {}\nPart 2: {}\n", p1, p2);
+        return 0;
+    }
+#endif
+
+    assert(process_log<big_uint>(test_data, 256).to_string() == "26984457539");
+    assert(process_log<big_uint>(test_data, 0).to_string() == "5");
+    {
+        const std::array<timer_counts, 2> schools{count_timers(test_data), timer_counts{1}};
+        assert((apply_growth_batch(growth_after<18>, schools) == std::vector<std::int64_t>{26, 7}));
+    }
+
     if (argc < 2) {
         fmt::print(stderr, "No input\n");
         return -1;
     }
 
-    auto const input = read_vector(argv[1]);
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [](const char* path) {
+            auto const counts = count_timers(read_vector(path));
+            return fmt::format("{} {}", apply_growth(growth_after<80>, counts),
+                               apply_growth(growth_after<256>, counts));
+        });
+    }
+
+    auto const counts = count_timers(read_vector(argv[1]));
 
-    fmt::print("Part 1: {}\n", process(input, 80));
-    fmt::print("Part 2: {}\n", process(input, 256));
+    fmt::print("Part 1: {}\n", apply_growth(growth_after<80>, counts));
+    fmt::print("Part 2: {}\n", apply_growth(growth_after<256>, counts));
 }
\ No newline at end of file
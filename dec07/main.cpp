@@ -15,49 +15,98 @@ constexpr auto read_vector = [](const char* filename) -> std::vector<int>
     return vec;
 };
 
-constexpr auto part1 = [](auto input)
+struct fuel_minima {
+    std::int64_t linear;
+    std::int64_t triangular;
+};
+
+// Rather than guessing where the optimum lies, we try every position between
+// the outermost crabs. Sweeping left to right over a histogram of positions,
+// running sums of the counts, positions and squared positions of the crabs
+// at or before the target give the cost there in O(1):
+//
+//   linear     = sum |t - x|
+//   quadratic  = sum (t - x)^2 = n t^2 - 2 t S + S2
+//   triangular = sum |t - x| (|t - x| + 1) / 2 = (quadratic + linear) / 2
+//
+// This is O(n + range) overall, and exact.
+constexpr auto min_fuel = [](const auto& input) -> fuel_minima
 {
-    // The target distance should (I think?) be the median of the input elements
-    // We can find this using std::nth_element
-    // (Open question: is copy + nth_element cheaper than just brute-force trying all
-    //  values in the range [input_min, input_max]?
+    if (std::ranges::empty(input)) {
+        return {0, 0};
+    }
 
-    std::ranges::nth_element(input, input.begin() + input.size()/2);
-    const int median = input[input.size()/2];
+    // Work relative to the leftmost crab to keep the sums small
+    const auto [lo, hi] = std::ranges::minmax(input);
+    std::vector<std::int64_t> histogram(static_cast<std::size_t>(hi - lo) + 1);
+
+    std::int64_t n = 0, sum = 0, sum_sq = 0;
+    for (int val : input) {
+        const std::int64_t x = val - lo;
+        ++histogram[x];
+        ++n;
+        sum += x;
+        sum_sq += x * x;
+    }
 
-    return flow::map(input, [&](int val) { return std::abs(median - val); }).sum();
+    fuel_minima best{std::numeric_limits<std::int64_t>::max(), std::numeric_limits<std::int64_t>::max()};
+    std::int64_t n_left = 0, sum_left = 0;
+
+    for (std::int64_t t = 0; t < std::ssize(histogram); t++) {
+        n_left += histogram[t];
+        sum_left += histogram[t] * t;
+
+        const auto linear = (t * n_left - sum_left) + ((sum - sum_left) - t * (n - n_left));
+        const auto quadratic = n * t * t - 2 * t * sum + sum_sq;
+
+        best.linear = std::min(best.linear, linear);
+        best.triangular = std::min(best.triangular, (quadratic + linear) / 2);
+    }
+
+    return best;
+};
+
+constexpr auto part1 = [](const auto& input)
+{
+    return min_fuel(input).linear;
 };
 
 constexpr auto part2 = [](const auto& input)
 {
-    // Hypothesis: target distance is somewhere around the mean, so let's just try
-    // a couple of values either side
-    const int mean = flow::sum(input)/input.size();
-
-    return flow::ints(mean - 2, mean + 3)
-        .map([&input](int i) {
-            return flow::map(input, [i] (int val) {
-                const int abs = std::abs(i - val);
-                return abs * (1 + abs)/2; // sum of [1, 2, ..., abs]
-            }).sum();
-        })
-        .min().value();
+    return min_fuel(input).triangular;
 };
 
 constexpr std::array test_data = {16,1,2,0,4,2,7,1,2,14};
 
 static_assert(part1(test_data) == 37);
 static_assert(part2(test_data) == 168);
+static_assert(part1(std::array{5}) == 0);
+static_assert(part2(std::array{-3, 3}) == 12);
 
 int main(int argc, char** argv)
 {
+#ifdef AOC_HAS_EMBEDDED_INPUT
+    {
+        constexpr auto fuel = [] { return min_fuel(aoc::parse_ints(aoc::embedded_input, ",")); }();
+        fmt::print("Part 1: {}\nPart 2: {}\n", fuel.linear, fuel.triangular);
+        return 0;
+    }
+#endif
+
     if (argc < 2) {
         fmt::print(stderr, "No input\n");
         return -1;
     }
 
-    const auto input = read_vector(argv[1]);
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [](const char* path) {
+            const auto fuel = min_fuel(read_vector(path));
+            return fmt::format("{} {}", fuel.linear, fuel.triangular);
+        });
+    }
+
+    const auto fuel = min_fuel(read_vector(argv[1]));
 
-    fmt::print("Part 1: {}\n", part1(input));
-    fmt::print("Part 2: {}\n", part2(input));
+    fmt::print("Part 1: {}\n", fuel.linear);
+    fmt::print("Part 2: {}\n", fuel.triangular);
 }
@@ -178,6 +178,14 @@ int main(int argc, char** argv)
         return -1;
     }
 
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [](const char* path) {
+            std::string const input = aoc::string_from_file(path);
+            auto const displays = parse_input(input);
+            return fmt::format("{} {}", part1(displays), part2(displays));
+        });
+    }
+
     std::string const input = aoc::string_from_file(argv[1]);
     auto const displays = parse_input(input);
 
@@ -98,6 +98,13 @@ int main(int argc, char** argv)
         return -1;
     }
 
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [](const char* path) {
+            auto const input = read_input(path);
+            return fmt::format("{} {}", part1(input), part2(input));
+        });
+    }
+
     auto const input = read_input(argv[1]);
 
     fmt::print("Part 1: {}\n", part1(input));
@@ -113,6 +113,13 @@ int main(int argc, char** argv)
         return -1;
     }
 
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [](const char* path) {
+            auto const [part1, part2] = calculate(aoc::string_from_file(path));
+            return fmt::format("{} {}", part1, part2);
+        });
+    }
+
     auto const input = aoc::string_from_file(argv[1]);
 
     auto const [part1, part2] = calculate(input);
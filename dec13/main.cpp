@@ -55,7 +55,7 @@ constexpr auto part2 = [](auto points, auto const& folds)
     return points;
 };
 
-constexpr auto display_points = [](auto const& points)
+constexpr auto display_points = [](auto const& points, std::ostream& os = std::cout)
 {
     auto [min_x, max_x] = flow::map(points, &point::x).minmax().value();
     auto [min_y, max_y] = flow::map(points, &point::y).minmax().value();
@@ -66,7 +66,7 @@ constexpr auto display_points = [](auto const& points)
                     contains(points, {x, y}) ? '#' : ' ';
         },
         flow::iota(min_y, max_y + 1), flow::iota(min_x, max_x + 2))
-        .write_to(std::cout, "");
+        .write_to(os, "");
 };
 
 constexpr auto parse_points = [](std::string_view input)
@@ -144,6 +144,19 @@ int main(int argc, char** argv)
         fmt::print(stderr, "No input");
     }
 
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [](const char* path) {
+            // Part 2 is a picture, so it goes on the lines after part 1
+            auto const input = aoc::string_from_file(path);
+            auto const [points, folds] = parse_input(input);
+            std::ostringstream picture;
+            display_points(part2(points, folds), picture);
+            auto str = fmt::format("{}\n{}", part1(points, folds), picture.str());
+            str.pop_back(); // run_batch ends the line
+            return str;
+        });
+    }
+
     auto const input = aoc::string_from_file(argv[1]);
 
     auto const [points, folds] = parse_input(input);
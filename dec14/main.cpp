@@ -104,6 +104,14 @@ int main(int argc, char** argv)
         return -1;
     }
 
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [](const char* path) {
+            auto const input = aoc::string_from_file(path);
+            auto const [templ, rules] = parse_input(input);
+            return fmt::format("{} {}", part1(templ, rules), part2(templ, rules));
+        });
+    }
+
     auto const input = aoc::string_from_file(argv[1]);
     auto const [templ, rules] = parse_input(input);
 
@@ -117,6 +117,12 @@ auto sum_versions(packet const& p) -> int
 
 auto calculate_value(packet const& p) -> uint64_t
 {
+    constexpr std::array<const char*, 8> op_names = {
+        "sum", "product", "min", "max", "literal", "greater", "less", "equal"
+    };
+
+    auto scope = aoc::trace_scope(p.type < op_names.size() ? op_names[p.type] : "unknown");
+
     switch (p.type) {
     case 0: return flow::map(p.subpackets, &calculate_value).sum();
     case 1: return flow::map(p.subpackets, &calculate_value).product();
@@ -130,17 +136,24 @@ auto calculate_value(packet const& p) -> uint64_t
     }
 }
 
-auto part1(std::string_view input) -> int
+auto parse_transmission(std::string_view input) -> packet
 {
+    auto scope = aoc::trace_scope("parse");
     auto reader = bit_reader(input);
-    auto packet = parse_packet(reader).first;
+    return parse_packet(reader).first;
+}
+
+auto part1(std::string_view input) -> int
+{
+    auto scope = aoc::trace_scope("part1");
+    auto packet = parse_transmission(input);
     return sum_versions(packet);
 }
 
 auto part2(std::string_view input) -> uint64_t
 {
-    auto reader = bit_reader(input);
-    auto packet = parse_packet(reader).first;
+    auto scope = aoc::trace_scope("part2");
+    auto packet = parse_transmission(input);
     return calculate_value(packet);
 }
 
@@ -167,13 +180,22 @@ int main(int argc, char** argv)
         return -1;
     }
 
-    auto const input = [&] {
-        auto str = aoc::string_from_file(argv[1]);
-        if (str.back() == '\n') {
+    auto const read_input = [](const char* path) {
+        auto str = aoc::string_from_file(path);
+        if (!str.empty() && str.back() == '\n') {
             str.pop_back();
         }
         return str;
-    }();
+    };
+
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [&read_input](const char* path) {
+            auto const input = read_input(path);
+            return fmt::format("{} {}", part1(input), part2(input));
+        });
+    }
+
+    auto const input = read_input(argv[1]);
 
     fmt::print("Part 1: {}\n", part1(input));
     fmt::print("Part 2: {}\n", part2(input));
@@ -202,6 +202,13 @@ int main(int argc, char** argv)
         return -1;
     }
 
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [](const char* path) {
+            const auto input = aoc::string_from_file(path);
+            return fmt::format("{} {}", part1(input), part2(input));
+        });
+    }
+
     const auto input = aoc::string_from_file(argv[1]);
 
     fmt::print("Part 1: {}\n", part1(input));
@@ -104,6 +104,14 @@ int main(int argc, char** argv)
         return -1;
     }
 
+    if (aoc::is_batch(argc, argv)) {
+        return aoc::run_batch({argv + 1, argv + argc}, [](const char* path) {
+            auto const input = aoc::string_from_file(path);
+            auto const [str, img] = parse_input(input);
+            return fmt::format("{} {}", part1(str, img), part2(str, img));
+        });
+    }
+
     auto const input = aoc::string_from_file(argv[1]);
 
     auto const [str, img] = parse_input(input);
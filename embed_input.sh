@@ -0,0 +1,22 @@
+#!/bin/sh
+# Writes the contents of an input file as a C++ raw string literal, for
+# compile-time solving on compilers without #embed:
+#
+#   ./embed_input.sh input.txt input.inc
+#   g++ -std=c++20 -DAOC_EMBED_HEADER='"input.inc"' main.cpp
+
+if [ $# -ne 2 ]; then
+    echo "Usage: $0 <input file> <output header>" >&2
+    exit 1
+fi
+
+if grep -q ')aoc_input"' "$1"; then
+    echo "$1 contains the raw string delimiter" >&2
+    exit 1
+fi
+
+{
+    printf 'R"aoc_input('
+    cat "$1"
+    printf ')aoc_input"\n'
+} > "$2"